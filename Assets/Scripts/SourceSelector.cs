@@ -9,8 +9,24 @@ public sealed class SourceSelector : MonoBehaviour
 {
     [SerializeField] SpoutReceiver _receiver = null;
 
+    List<string> _sourceList;
+    uint _sourceListVersion;
+
+    // Source name list, only refreshed when the source list has changed
     [CreateProperty]
-    public List<string> SourceList => SpoutManager.GetSourceNames().ToList();
+    public List<string> SourceList
+    {
+        get
+        {
+            var version = SpoutManager.SourceListVersion;
+            if (_sourceList == null || _sourceListVersion != version)
+            {
+                _sourceList = SpoutManager.GetSourceNames().ToList();
+                _sourceListVersion = version;
+            }
+            return _sourceList;
+        }
+    }
 
     VisualElement UIRoot
       => GetComponent<UIDocument>().rootVisualElement;
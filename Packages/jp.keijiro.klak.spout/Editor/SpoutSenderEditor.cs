@@ -9,6 +9,9 @@ sealed class SpoutSenderEditor : UnityEditor.Editor
 {
     SerializedProperty _spoutName;
     SerializedProperty _keepAlpha;
+    SerializedProperty _hdr;
+    SerializedProperty _directCopy;
+    SerializedProperty _bufferCount;
     SerializedProperty _captureMethod;
     SerializedProperty _sourceCamera;
     SerializedProperty _sourceTexture;
@@ -16,6 +19,7 @@ sealed class SpoutSenderEditor : UnityEditor.Editor
     static class Labels
     {
         public static Label SpoutName = "Spout Name";
+        public static Label Hdr = "HDR";
     }
 
     // Sender restart request
@@ -36,6 +40,9 @@ void OnEnable()
         var finder = new PropertyFinder(serializedObject);
         _spoutName = finder["_spoutName"];
         _keepAlpha = finder["_keepAlpha"];
+        _hdr = finder["_hdr"];
+        _directCopy = finder["_directCopy"];
+        _bufferCount = finder["_bufferCount"];
         _captureMethod = finder["_captureMethod"];
         _sourceCamera = finder["_sourceCamera"];
         _sourceTexture = finder["_sourceTexture"];
@@ -50,6 +57,12 @@ public override void OnInspectorGUI()
         var restart = EditorGUI.EndChangeCheck();
 
         EditorGUILayout.PropertyField(_keepAlpha);
+        EditorGUILayout.PropertyField(_hdr, Labels.Hdr);
+
+        EditorGUI.BeginChangeCheck();
+        EditorGUILayout.PropertyField(_bufferCount);
+        restart |= EditorGUI.EndChangeCheck();
+
         EditorGUILayout.PropertyField(_captureMethod);
 
         EditorGUI.indentLevel++;
@@ -60,7 +73,10 @@ public override void OnInspectorGUI()
 
         if (_captureMethod.hasMultipleDifferentValues ||
             _captureMethod.enumValueIndex == (int)CaptureMethod.Texture)
+        {
             EditorGUILayout.PropertyField(_sourceTexture);
+            EditorGUILayout.PropertyField(_directCopy);
+        }
 
         EditorGUI.indentLevel--;
 
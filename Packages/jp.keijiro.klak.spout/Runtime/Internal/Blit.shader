@@ -95,5 +95,13 @@ Shader "Hidden/Klak/Spout/Blit"
             #pragma multi_compile _ UNITY_COLORSPACE_GAMMA
             ENDCG
         }
+        Pass
+        {
+            CGPROGRAM
+            #pragma vertex VertexVFlip
+            #pragma fragment BlitFromSrgb
+            #pragma multi_compile _ UNITY_COLORSPACE_GAMMA
+            ENDCG
+        }
     }
 }
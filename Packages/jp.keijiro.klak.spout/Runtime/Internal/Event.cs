@@ -12,7 +12,9 @@ enum EventID
     UpdateSender,
     UpdateReceiver,
     CloseSender,
-    CloseReceiver
+    CloseReceiver,
+    UpdateAllReceivers, // No attachment data
+    FlushSenders        // No attachment data
 }
 
 // Render event attachment data structure
@@ -44,6 +46,15 @@ public EventKicker(EventData data)
     public void Dispose()
       => MemoryPool.FreeOnEndOfFrame(_dataMem);
 
+    // Texture pointer replacement in the pinned attachment data
+    // The render thread picks up the new pointer from the next event.
+    public void SetTexturePointer(IntPtr texture)
+      => Marshal.WriteIntPtr(_dataMem.AddrOfPinnedObject(),
+                             TexturePointerOffset, texture);
+
+    static readonly int TexturePointerOffset =
+      (int)Marshal.OffsetOf<EventData>(nameof(EventData.texturePointer));
+
     public void IssuePluginEvent(EventID eventID)
     {
         if (_cmdBuffer == null)
@@ -1,4 +1,5 @@
 using UnityEngine;
+using UnityEngine.Experimental.Rendering;
 
 namespace Klak.Spout {
 
@@ -38,6 +39,21 @@ public static bool IsSRGB(this Format format)
     {
         return format == Format.RGBA32_SRGB || format == Format.BGRA32_SRGB;
     }
+
+    // Spout-compatible format of a texture (Unknown : not compatible)
+    public static Format FromGraphicsFormat(GraphicsFormat format)
+    {
+        switch (format)
+        {
+            case GraphicsFormat.R8G8B8A8_UNorm:      return Format.RGBA32;
+            case GraphicsFormat.R8G8B8A8_SRGB:       return Format.RGBA32_SRGB;
+            case GraphicsFormat.B8G8R8A8_UNorm:      return Format.BGRA32;
+            case GraphicsFormat.B8G8R8A8_SRGB:       return Format.BGRA32_SRGB;
+            case GraphicsFormat.R16G16B16A16_SFloat: return Format.RGBAHalf;
+            case GraphicsFormat.R32G32B32A32_SFloat: return Format.RGBAFloat;
+            default: return Format.Unknown;
+        }
+    }
 }
 
 } // namespace Klak.Spout
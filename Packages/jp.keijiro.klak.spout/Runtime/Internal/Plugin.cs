@@ -13,15 +13,56 @@ public struct ReceiverData
         public uint width, height;
         public Format format;
         public IntPtr texturePointer;
+        public int bottomUp;
     }
 
+    // Native interface version
+    // A binary built before GetInterfaceVersion was added (0) doesn't have the
+    // UpdateAllReceivers/FlushSenders events, the readback functions, the
+    // sender list version and the snapshot. The callers fall back to the
+    // older functions in that case. Version 2 adds the sender and lock
+    // statistics, version 3 the row order flag (SetSenderRowOrder and
+    // ReceiverData.bottomUp).
+    public const int CurrentInterfaceVersion = 3;
+
+    public static int InterfaceVersion
+    {
+        get
+        {
+            if (_interfaceVersion < 0)
+            {
+                try
+                {
+                    _interfaceVersion = GetInterfaceVersion();
+                }
+                catch (System.EntryPointNotFoundException)
+                {
+                    _interfaceVersion = 0;
+                }
+            }
+            return _interfaceVersion;
+        }
+    }
+
+    public static bool IsCurrent
+      => InterfaceVersion >= CurrentInterfaceVersion;
+
+    static int _interfaceVersion = -1;
+
 #if UNITY_EDITOR_WIN || UNITY_STANDALONE_WIN
 
+    [DllImport("KlakSpout")]
+    static extern int GetInterfaceVersion();
+
     [DllImport("KlakSpout")]
     public static extern IntPtr GetRenderEventCallback();
 
     [DllImport("KlakSpout")]
-    public static extern IntPtr CreateSender(string name, int width, int height);
+    public static extern IntPtr CreateSender
+      (string name, int width, int height, Format format, int bufferCount);
+
+    [DllImport("KlakSpout")]
+    public static extern void SetSenderRowOrder(IntPtr sender, int bottomUp);
 
     [DllImport("KlakSpout")]
     public static extern IntPtr CreateReceiver(string name);
@@ -29,25 +70,78 @@ public struct ReceiverData
     [DllImport("KlakSpout")]
     public static extern ReceiverData GetReceiverData(IntPtr receiver);
 
+    [DllImport("KlakSpout")]
+    public static extern void SetReceiverReadback(IntPtr receiver, int depth);
+
+    [DllImport("KlakSpout")]
+    public static extern int GetReceiverReadback
+      (IntPtr receiver, [Out] byte[] buffer, int size,
+       out SpoutReadbackInfo info);
+
+    [DllImport("KlakSpout")]
+    public static extern int GetReceiverReadback
+      (IntPtr receiver, IntPtr buffer, int size, out SpoutReadbackInfo info);
+
     [DllImport("KlakSpout")]
     public static extern void GetSenderNames
       ([Out, MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 1)]
        out IntPtr[] names, out int count);
 
+    [DllImport("KlakSpout")]
+    public static extern uint GetSenderListVersion();
+
+    [DllImport("KlakSpout")]
+    public static extern int GetSenderSnapshot
+      ([Out] SpoutSourceInfo[] entries, int capacity,
+       [Out] byte[] names, int namesSize);
+
+    [DllImport("KlakSpout")]
+    public static extern SpoutSenderStats GetSenderStats();
+
+    [DllImport("KlakSpout")]
+    public static extern void EnableLockStats(int enable);
+
+    [DllImport("KlakSpout")]
+    public static extern int GetLockStats
+      ([Out] SpoutLockStats[] entries, int capacity);
+
 #else
 
+    static int GetInterfaceVersion()
+      => CurrentInterfaceVersion;
+
     public static IntPtr GetRenderEventCallback()
       => IntPtr.Zero;
 
-    public static IntPtr CreateSender(string name, int width, int height)
+    public static IntPtr CreateSender
+      (string name, int width, int height, Format format, int bufferCount)
       => IntPtr.Zero;
 
+    public static void SetSenderRowOrder(IntPtr sender, int bottomUp) {}
+
     public static IntPtr CreateReceiver(string name)
       => IntPtr.Zero;
 
     public static ReceiverData GetReceiverData(IntPtr receiver)
       => new ReceiverData();
 
+    public static void SetReceiverReadback(IntPtr receiver, int depth) {}
+
+    public static int GetReceiverReadback
+      (IntPtr receiver, [Out] byte[] buffer, int size,
+       out SpoutReadbackInfo info)
+    {
+        info = new SpoutReadbackInfo();
+        return 0;
+    }
+
+    public static int GetReceiverReadback
+      (IntPtr receiver, IntPtr buffer, int size, out SpoutReadbackInfo info)
+    {
+        info = new SpoutReadbackInfo();
+        return 0;
+    }
+
     public static void GetSenderNames
       ([Out, MarshalAs(UnmanagedType.LPArray, SizeParamIndex = 1)]
        out IntPtr[] names, out int count)
@@ -56,6 +150,23 @@ public static void GetSenderNames
         count = 0;
     }
 
+    public static uint GetSenderListVersion()
+      => 0;
+
+    public static int GetSenderSnapshot
+      ([Out] SpoutSourceInfo[] entries, int capacity,
+       [Out] byte[] names, int namesSize)
+      => 0;
+
+    public static SpoutSenderStats GetSenderStats()
+      => new SpoutSenderStats();
+
+    public static void EnableLockStats(int enable) {}
+
+    public static int GetLockStats
+      ([Out] SpoutLockStats[] entries, int capacity)
+      => 0;
+
 #endif
 }
 
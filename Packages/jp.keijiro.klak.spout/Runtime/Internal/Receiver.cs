@@ -1,4 +1,6 @@
 using UnityEngine;
+using Unity.Collections;
+using Unity.Collections.LowLevel.Unsafe;
 using System.Runtime.InteropServices;
 using IntPtr = System.IntPtr;
 
@@ -13,6 +15,10 @@ sealed class Receiver : System.IDisposable
 
     public Texture2D Texture => _texture;
 
+    // The texture rows are in Unity's bottom-up order (a sender with the
+    // direct copy option), so it's blitted without the vertical flip.
+    public bool IsBottomUp { get; private set; }
+
     #endregion
 
     #region Private objects
@@ -20,6 +26,7 @@ sealed class Receiver : System.IDisposable
     IntPtr _plugin;
     EventKicker _event;
     Texture2D _texture;
+    Format _textureFormat;
 
     #endregion
 
@@ -64,6 +71,60 @@ public void Dispose()
 
     #endregion
 
+    #region CPU readback
+
+    // An outdated plugin binary doesn't have the readback functions, so the
+    // readback is disabled with a warning (once) in that case.
+
+    public void SetReadback(int depth)
+    {
+        if (_plugin == IntPtr.Zero) return;
+        if (!Plugin.IsCurrent)
+        {
+            if (depth > 0) WarnNoReadback();
+            return;
+        }
+        Plugin.SetReceiverReadback(_plugin, depth);
+    }
+
+    public int ReadPixels(byte[] buffer, out SpoutReadbackInfo info)
+    {
+        if (_plugin == IntPtr.Zero || !Plugin.IsCurrent)
+        {
+            info = new SpoutReadbackInfo();
+            return 0;
+        }
+        return Plugin.GetReceiverReadback
+          (_plugin, buffer, buffer != null ? buffer.Length : 0, out info);
+    }
+
+    // The native buffer is written in place (no marshaling or pinning).
+    public unsafe int ReadPixels(NativeArray<byte> buffer,
+                                 out SpoutReadbackInfo info)
+    {
+        if (_plugin == IntPtr.Zero || !Plugin.IsCurrent)
+        {
+            info = new SpoutReadbackInfo();
+            return 0;
+        }
+        var ptr = buffer.IsCreated ?
+          (IntPtr)NativeArrayUnsafeUtility.GetUnsafePtr(buffer) : IntPtr.Zero;
+        return Plugin.GetReceiverReadback
+          (_plugin, ptr, buffer.IsCreated ? buffer.Length : 0, out info);
+    }
+
+    static bool _readbackWarned;
+
+    static void WarnNoReadback()
+    {
+        if (_readbackWarned) return;
+        Debug.LogWarning("KlakSpout: The plugin binary is outdated. " +
+                         "The CPU readback is disabled.");
+        _readbackWarned = true;
+    }
+
+    #endregion
+
     #region Frame update method
 
     public void Update()
@@ -71,28 +132,58 @@ public void Update()
         if (_plugin == IntPtr.Zero) return;
 
         var data = Plugin.GetReceiverData(_plugin);
+        IsBottomUp = Plugin.IsCurrent && data.bottomUp != 0;
 
         // Texture refresh:
-        // If we are referring to an old texture pointer, destroy it first.
+        // If we are referring to an old texture pointer, replace it. The
+        // texture object is kept when only the pointer has changed (e.g. the
+        // slots of a multi-buffered sender), otherwise it's destroyed first.
         if (_texture != null &&
             _texture.GetNativeTexturePtr() != data.texturePointer)
         {
-            Utility.Destroy(_texture);
-            _texture = null;
+            if (data.texturePointer != IntPtr.Zero &&
+                _texture.width == (int)data.width &&
+                _texture.height == (int)data.height &&
+                _textureFormat == data.format)
+            {
+                _texture.UpdateExternalTexture(data.texturePointer);
+            }
+            else
+            {
+                Utility.Destroy(_texture);
+                _texture = null;
+            }
         }
 
         // Lazy initialization:
         // We try creating a receiver texture every frame until getting a
         // correct one.
         if (_texture == null && data.texturePointer != IntPtr.Zero)
+        {
             _texture = Texture2D.CreateExternalTexture
               ((int)data.width, (int)data.height, data.format.ToTextureFormat(),
                false, !data.format.IsSRGB(), data.texturePointer);
+            _textureFormat = data.format;
+        }
 
-        // Update event for the render thread
-        _event.IssuePluginEvent(EventID.UpdateReceiver);
+        // Update event for the render thread:
+        // All the receivers are updated with a single event once per frame,
+        // so that the sender list is read only once for them. An outdated
+        // plugin binary only has the per-receiver event.
+        if (!Plugin.IsCurrent)
+            _event.IssuePluginEvent(EventID.UpdateReceiver);
+        else if (_lastBatchFrame != Time.frameCount)
+        {
+            if (_batchEvent == null)
+                _batchEvent = new EventKicker(new EventData(IntPtr.Zero));
+            _batchEvent.IssuePluginEvent(EventID.UpdateAllReceivers);
+            _lastBatchFrame = Time.frameCount;
+        }
     }
 
+    static EventKicker _batchEvent;
+    static int _lastBatchFrame = -1;
+
     #endregion
 }
 
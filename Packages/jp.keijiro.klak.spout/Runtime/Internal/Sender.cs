@@ -1,4 +1,6 @@
 using UnityEngine;
+using UnityEngine.LowLevel;
+using System.Linq;
 using System.Runtime.InteropServices;
 using IntPtr = System.IntPtr;
 
@@ -18,12 +20,21 @@ sealed class Sender : System.IDisposable
 
     #region Object lifecycle
 
-    public Sender(string target, Texture texture)
+    // bottomUp: The texture is shared in Unity's bottom-up row order (no
+    // flipping blit). KlakSpout receivers flip it back; other receivers show
+    // it upside down. An outdated plugin binary can't flag it.
+    public Sender
+      (string target, Texture texture, Format format, int bufferCount,
+       bool bottomUp = false)
     {
         // Plugin object allocation
-        _plugin = Plugin.CreateSender(target, texture.width, texture.height);
+        _plugin = Plugin.CreateSender
+          (target, texture.width, texture.height, format, bufferCount);
         if (_plugin == IntPtr.Zero) return;
 
+        if (bottomUp && Plugin.IsCurrent)
+            Plugin.SetSenderRowOrder(_plugin, 1);
+
         // Event kicker (heap block for interop communication)
         _event = new EventKicker
           (new EventData(_plugin, texture.GetNativeTexturePtr()));
@@ -53,10 +64,83 @@ public void Dispose()
 
     #endregion
 
+    #region Texture replacement
+
+    // Replaces the source texture with a new one (e.g. after a resize).
+    // The plugin keeps the sender registered and publishes the new size.
+    public void SetTexture(Texture texture)
+      => _event?.SetTexturePointer(texture.GetNativeTexturePtr());
+
+    #endregion
+
     #region Frame update method
 
     public void Update()
-      => _event?.IssuePluginEvent(EventID.UpdateSender);
+    {
+        if (_event == null) return;
+
+        // Safety net: Flush of the previous frame if the player loop system
+        // hasn't run since then (e.g. in the edit mode)
+        if (_updateCount > 0 && _lastFrame != Time.frameCount) IssueFlush();
+
+        _event.IssuePluginEvent(EventID.UpdateSender);
+        _updateCount++;
+        _lastFrame = Time.frameCount;
+    }
+
+    // Flush event:
+    // The D3D11On12 fallback of the D3D12 mode submits the copies of all the
+    // senders with a single flush, which is issued once per frame at the
+    // beginning of EarlyUpdate. The sender updates run at the end of the
+    // previous frame, so these frames are one frame late. The native D3D12
+    // path submits at every update and doesn't wait for this.
+    static void OnEarlyUpdate()
+    {
+        if (_updateCount > 0) IssueFlush();
+    }
+
+    static void IssueFlush()
+    {
+        _updateCount = 0;
+
+        // An outdated plugin binary flushes every sender update by itself.
+        if (!Plugin.IsCurrent) return;
+
+        if (_flushEvent == null)
+            _flushEvent = new EventKicker(new EventData(IntPtr.Zero));
+        _flushEvent.IssuePluginEvent(EventID.FlushSenders);
+    }
+
+    static EventKicker _flushEvent;
+    static int _updateCount;
+    static int _lastFrame = -1;
+
+    #endregion
+
+    #region PlayerLoopSystem implementation
+
+    static Sender() => InsertPlayerLoopSystem();
+
+    static void InsertPlayerLoopSystem()
+    {
+        var customSystem = new PlayerLoopSystem()
+          { type = typeof(Sender), updateDelegate = OnEarlyUpdate };
+
+        var playerLoop = PlayerLoop.GetCurrentPlayerLoop();
+
+        for (var i = 0; i < playerLoop.subSystemList.Length; i++)
+        {
+            ref var phase = ref playerLoop.subSystemList[i];
+            if (phase.type == typeof(UnityEngine.PlayerLoop.EarlyUpdate))
+            {
+                phase.subSystemList = new [] { customSystem }
+                  .Concat(phase.subSystemList).ToArray();
+                break;
+            }
+        }
+
+        PlayerLoop.SetPlayerLoop(playerLoop);
+    }
 
     #endregion
 }
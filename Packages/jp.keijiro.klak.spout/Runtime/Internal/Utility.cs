@@ -36,6 +36,10 @@ public static void BlitFromSrgb
       (SpoutResources resrc, Texture src, RenderTexture dst)
       => Graphics.Blit(src, dst, GetMaterial(resrc), 4);
 
+    public static void BlitFromSrgbVFlip
+      (SpoutResources resrc, Texture src, RenderTexture dst)
+      => Graphics.Blit(src, dst, GetMaterial(resrc), 5);
+
     static Material _material;
 
     static Material GetMaterial(SpoutResources resrc)
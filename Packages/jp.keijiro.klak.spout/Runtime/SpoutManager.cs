@@ -1,10 +1,95 @@
 using System.Runtime.InteropServices;
+using Encoding = System.Text.Encoding;
 using IntPtr = System.IntPtr;
 
 namespace Klak.Spout {
 
+//
+// Spout source metadata entry (see SpoutManager.GetSourceInfo)
+// Should match with SpoutSenderSnapshot (SpoutSenderNames.h)
+//
+[StructLayout(LayoutKind.Sequential)]
+public struct SpoutSourceInfo
+{
+    public int nameOffset;   // Name position in the name buffer
+    public int nameLength;   // Name length in bytes (0 if it didn't fit)
+    public uint width, height;
+    public Format format;
+    public uint shareHandle;
+    public uint stamp;       // Changes on every update (0 for legacy senders)
+
+    // This allocates a string, so cache it for frequent use.
+    public string GetName(byte[] nameBuffer)
+      => Encoding.UTF8.GetString(nameBuffer, nameOffset, nameLength);
+}
+
+//
+// Sender counters (see SpoutManager.GetSenderStats)
+// Should match with KlakSpout::System::SenderStats (System.h)
+//
+[StructLayout(LayoutKind.Sequential)]
+public struct SpoutSenderStats
+{
+    public uint frames;        // Flush events
+    public uint wrapCreations; // D3D11On12 wrapped resource creations
+    public uint flushes;       // D3D11On12 flushes
+    public uint submissions;   // D3D12 copy queue submissions (per update)
+}
+
+//
+// Lock wait counters of a shared memory map (see SpoutManager.GetLockStats)
+// Should match with SpoutLockStatsData (SpoutLockStats.h)
+//
+[StructLayout(LayoutKind.Sequential)]
+public struct SpoutLockStats
+{
+    [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 256)]
+    public string name;
+    public ulong acquisitions; // Successful non re-entrant locks
+    public ulong reentrant;    // Re-entrant locks
+    public ulong timeouts;     // Locks that failed to acquire the mutex
+    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 20)]
+    public ulong[] waitHistogram; // Mutex wait time (see SpoutLockStats.h)
+}
+
 public static class SpoutManager
 {
+    //
+    // GetSourceInfo - Retrieves metadata of all available Spout sources
+    //
+    // Fills up to infos.Length entries and returns the number of sources.
+    // The names are stored in nameBuffer; a buffer of infos.Length * 256 bytes
+    // is always large enough. The arrays can be reused every frame without
+    // GC memory allocations. With an outdated plugin binary, only the names
+    // are retrieved (with GC allocations) and the other fields are zero.
+    //
+    public static int GetSourceInfo(SpoutSourceInfo[] infos, byte[] nameBuffer)
+      => Plugin.IsCurrent
+           ? Plugin.GetSenderSnapshot
+               (infos, infos.Length, nameBuffer, nameBuffer.Length)
+           : GetSourceInfoFromNames(infos, nameBuffer);
+
+    static int GetSourceInfoFromNames(SpoutSourceInfo[] infos, byte[] nameBuffer)
+    {
+        var names = GetSourceNames();
+        var offset = 0;
+        for (var i = 0; i < names.Length && i < infos.Length; i++)
+        {
+            var info = new SpoutSourceInfo();
+            info.nameOffset = offset;
+            var length = Encoding.UTF8.GetByteCount(names[i]);
+            if (offset + length + 1 <= nameBuffer.Length)
+            {
+                Encoding.UTF8.GetBytes(names[i], 0, names[i].Length, nameBuffer, offset);
+                nameBuffer[offset + length] = 0;
+                info.nameLength = length;
+                offset += length + 1;
+            }
+            infos[i] = info;
+        }
+        return names.Length;
+    }
+
     //
     // GetSourceNames - Enumerates names of all available Spout sources
     //
@@ -28,6 +113,42 @@ public static string[] GetSourceNames()
 
         return names;
     }
+
+    //
+    // SourceListVersion - Counter that changes when the source list changes
+    //
+    // This is cheap enough to check every frame. Use it to refresh the cached
+    // results of GetSourceNames only when the source list has changed.
+    // With an outdated plugin binary, it changes every frame.
+    //
+    public static uint SourceListVersion
+      => Plugin.IsCurrent ? Plugin.GetSenderListVersion()
+                          : (uint)UnityEngine.Time.frameCount;
+
+    //
+    // GetSenderStats - Cumulative counters of the senders in this process
+    //
+    // Dividing the wrap creations and the flushes by the frames gives the
+    // per-frame rates. All zero with an outdated plugin binary.
+    //
+    public static SpoutSenderStats GetSenderStats()
+      => Plugin.IsCurrent ? Plugin.GetSenderStats() : new SpoutSenderStats();
+
+    //
+    // LockStatsEnabled - Records the shared memory lock waits when enabled
+    //
+    public static bool LockStatsEnabled
+      { set { if (Plugin.IsCurrent) Plugin.EnableLockStats(value ? 1 : 0); } }
+
+    //
+    // GetLockStats - Lock wait counters of the shared memory maps
+    //
+    // Fills up to entries.Length entries and returns the number of maps.
+    // This invokes GC memory allocations (names and histograms), so it's
+    // meant for diagnostics, not for every frame.
+    //
+    public static int GetLockStats(SpoutLockStats[] entries)
+      => Plugin.IsCurrent ? Plugin.GetLockStats(entries, entries.Length) : 0;
 }
 
 } // namespace Klak.Spout
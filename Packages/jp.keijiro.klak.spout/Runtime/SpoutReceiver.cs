@@ -1,7 +1,23 @@
 using UnityEngine;
+using System.Runtime.InteropServices;
 
 namespace Klak.Spout {
 
+//
+// CPU readback frame information (see SpoutReceiver.ReadPixels)
+// Should match with KlakSpout::ReadbackInfo (Readback.h)
+//
+[StructLayout(LayoutKind.Sequential)]
+public struct SpoutReadbackInfo
+{
+    public ulong stamp;     // Frame number (0 : no frame yet)
+    public uint width, height;
+    public uint rowPitch;   // Bytes per row (rows are tightly packed)
+    public Format format;
+
+    public int size => (int)(rowPitch * height);
+}
+
 //
 // Spout receiver class (main implementation)
 //
@@ -77,7 +93,10 @@ void Update()
     {
         // Receiver lazy initialization
         if (_receiver == null)
+        {
             _receiver = new Receiver(_sourceName);
+            _receiver.SetReadback(_readbackDepth);
+        }
 
         // Receiver plugin-side update
         _receiver.Update();
@@ -86,11 +105,23 @@ void Update()
         if (_receiver.Texture == null) return;
 
         // Received texture buffering
+        // Frames of a direct copy sender are in Unity's row order already.
         var buffer = PrepareBuffer();
-        if (buffer.isDataSRGB)
-            Blitter.BlitFromSrgb(_resources, _receiver.Texture, buffer);
+        var source = _receiver.Texture;
+        if (_receiver.IsBottomUp)
+        {
+            if (buffer.isDataSRGB)
+                Blitter.BlitFromSrgbVFlip(_resources, source, buffer);
+            else
+                Blitter.BlitVFlip(_resources, source, buffer, true);
+        }
         else
-            Blitter.Blit(_resources, _receiver.Texture, buffer, true);
+        {
+            if (buffer.isDataSRGB)
+                Blitter.BlitFromSrgb(_resources, source, buffer);
+            else
+                Blitter.Blit(_resources, source, buffer, true);
+        }
 
         // Renderer override
         if (_targetRenderer != null)
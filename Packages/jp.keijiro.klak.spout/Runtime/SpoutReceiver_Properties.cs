@@ -1,4 +1,5 @@
 using UnityEngine;
+using Unity.Collections;
 
 namespace Klak.Spout {
 
@@ -47,11 +48,70 @@ public string targetMaterialProperty
 
     #endregion
 
+    #region CPU readback
+
+    int _readbackDepth;
+
+    //
+    // readbackDepth - Number of staging textures for the CPU readback
+    //
+    // The CPU reads a frame that is (readbackDepth - 1) frames old, so that
+    // it never waits for the GPU. Set zero to disable the readback.
+    //
+    public int readbackDepth
+      { get => _readbackDepth;
+        set => ChangeReadbackDepth(value); }
+
+    void ChangeReadbackDepth(int depth)
+    {
+        if (_readbackDepth == depth) return;
+        _readbackDepth = depth;
+        _receiver?.SetReadback(depth);
+    }
+
+    //
+    // ReadPixels - Copies the latest readback frame into a buffer
+    //
+    // Returns the copied size, or zero if there is no frame yet or the buffer
+    // is smaller than info.size. The frame information is always returned,
+    // and info.stamp tells if the frame is new. The buffer is pinned during
+    // the call without any GC memory allocation. The rows are top-down, or
+    // bottom-up if isSourceBottomUp is set (a direct copy sender).
+    //
+    public int ReadPixels(byte[] buffer, out SpoutReadbackInfo info)
+    {
+        if (_receiver == null)
+        {
+            info = new SpoutReadbackInfo();
+            return 0;
+        }
+        return _receiver.ReadPixels(buffer, out info);
+    }
+
+    // NativeArray version : The frame is copied straight into the native
+    // buffer, e.g. for a job or an encoder that takes a NativeArray.
+    public int ReadPixels(NativeArray<byte> buffer, out SpoutReadbackInfo info)
+    {
+        if (_receiver == null)
+        {
+            info = new SpoutReadbackInfo();
+            return 0;
+        }
+        return _receiver.ReadPixels(buffer, out info);
+    }
+
+    #endregion
+
     #region Runtime property
 
     public RenderTexture receivedTexture
       => _buffer != null ? _buffer : _targetTexture;
 
+    // The sender shares its frames in bottom-up row order (direct copy).
+    // receivedTexture is flipped accordingly; ReadPixels rows are not.
+    public bool isSourceBottomUp
+      => _receiver != null && _receiver.IsBottomUp;
+
     #endregion
 
     #region Resource asset reference
@@ -1,5 +1,6 @@
 using UnityEngine;
 using UnityEngine.Rendering;
+using UnityEngine.Experimental.Rendering;
 
 namespace Klak.Spout {
 
@@ -25,14 +26,19 @@ void ReleaseSender()
     #region Buffer texture object
 
     RenderTexture _buffer;
+    Format _bufferFormat;
 
-    void PrepareBuffer(int width, int height)
+    void PrepareBuffer(int width, int height, Format format = Format.RGBA32)
     {
-        // If the buffer exists but has wrong dimensions, destroy it first.
+        // If the buffer exists but has wrong dimensions or format, destroy it
+        // first. A resize keeps the sender, which is given the new buffer
+        // below, so that it stays registered and receivers don't reconnect.
         if (_buffer != null &&
-            (_buffer.width != width || _buffer.height != height))
+            (_buffer.width != width || _buffer.height != height ||
+             _bufferFormat != format))
         {
-            ReleaseSender();
+            if (_bufferFormat != format || width == 0 || height == 0)
+                ReleaseSender();
             Utility.Destroy(_buffer);
             _buffer = null;
         }
@@ -40,9 +46,69 @@ void PrepareBuffer(int width, int height)
         // Create a buffer if it hasn't been allocated yet.
         if (_buffer == null && width > 0 && height > 0)
         {
-            _buffer = new RenderTexture(width, height, 0);
+            _buffer = format == Format.RGBA32 ?
+              new RenderTexture(width, height, 0) :
+              new RenderTexture(width, height, 0, ToGraphicsFormat(format));
             _buffer.hideFlags = HideFlags.DontSave;
             _buffer.Create();
+            _bufferFormat = format;
+            _sender?.SetTexture(_buffer);
+        }
+    }
+
+    // Buffer format for a source: With the HDR option, half and float
+    // sources keep their precision.
+    Format GetBufferFormat(GraphicsFormat source)
+    {
+        if (!_hdr) return Format.RGBA32;
+        var format = FormatUtil.FromGraphicsFormat(source);
+        return format == Format.RGBAHalf || format == Format.RGBAFloat ?
+          format : Format.RGBA32;
+    }
+
+    static GraphicsFormat ToGraphicsFormat(Format format)
+      => format == Format.RGBAFloat ? GraphicsFormat.R32G32B32A32_SFloat :
+                                      GraphicsFormat.R16G16B16A16_SFloat;
+
+    #endregion
+
+    #region Direct copy source
+
+    // Source texture shared without the conversion blit
+    Texture _directSource;
+    int _directWidth, _directHeight;
+
+    // The texture is copied as it is, so it has to be a single-level
+    // Spout-compatible texture (8-bit unless the HDR option is on). The
+    // plugin has to be able to flag the bottom-up rows.
+    bool CanCopyDirectly(Texture source)
+    {
+        if (!_directCopy || !_keepAlpha || !Plugin.IsCurrent) return false;
+        if (source.dimension != TextureDimension.Tex2D) return false;
+        if (source.mipmapCount != 1) return false;
+        if (source is RenderTexture rt && rt.antiAliasing > 1) return false;
+        var format = FormatUtil.FromGraphicsFormat(source.graphicsFormat);
+        if (format == Format.RGBAHalf || format == Format.RGBAFloat)
+            return _hdr;
+        return format != Format.Unknown;
+    }
+
+    void PrepareDirectSource(Texture source)
+    {
+        // The sender is recreated when the source texture is replaced.
+        if (_directSource != source)
+        {
+            ReleaseSender();
+            _directSource = source;
+        }
+
+        // On a resize, the sender is given the reallocated texture.
+        if (source != null && (source.width != _directWidth ||
+                               source.height != _directHeight))
+        {
+            _sender?.SetTexture(source);
+            _directWidth = source.width;
+            _directHeight = source.height;
         }
     }
 
@@ -99,6 +165,7 @@ void CaptureFrame()
         // GameView capture mode
         if (_captureMethod == CaptureMethod.GameView)
         {
+            PrepareDirectSource(null);
             PrepareBuffer(Screen.width, Screen.height);
             RenderTexture.active = null;
             var temp = RenderTexture.GetTemporary(Screen.width, Screen.height, 0);
@@ -111,20 +178,40 @@ void CaptureFrame()
         if (_captureMethod == CaptureMethod.Texture)
         {
             if (_sourceTexture == null) return;
-            PrepareBuffer(_sourceTexture.width, _sourceTexture.height);
-            Blitter.Blit(_resources, _sourceTexture, _buffer, _keepAlpha);
+            if (CanCopyDirectly(_sourceTexture))
+            {
+                // Direct copy: No buffer, no blit (bottom-up rows)
+                PrepareBuffer(0, 0);
+                PrepareDirectSource(_sourceTexture);
+            }
+            else
+            {
+                PrepareDirectSource(null);
+                PrepareBuffer(_sourceTexture.width, _sourceTexture.height,
+                              GetBufferFormat(_sourceTexture.graphicsFormat));
+                Blitter.Blit(_resources, _sourceTexture, _buffer, _keepAlpha);
+            }
         }
 
         // Camera capture mode
         if (_captureMethod == CaptureMethod.Camera)
         {
+            PrepareDirectSource(null);
             PrepareCameraCapture(_sourceCamera);
             if (_sourceCamera == null) return;
-            PrepareBuffer(_sourceCamera.pixelWidth, _sourceCamera.pixelHeight);
+            PrepareBuffer(_sourceCamera.pixelWidth, _sourceCamera.pixelHeight,
+                          _hdr && _sourceCamera.allowHDR ? Format.RGBAHalf
+                                                        : Format.RGBA32);
         }
 
         // Sender lazy initialization
-        if (_sender == null) _sender = new Sender(_spoutName, _buffer);
+        if (_sender == null)
+            _sender = _directSource != null ?
+              new Sender(_spoutName, _directSource,
+                         FormatUtil.FromGraphicsFormat
+                           (_directSource.graphicsFormat),
+                         _bufferCount, true) :
+              new Sender(_spoutName, _buffer, _bufferFormat, _bufferCount);
 
         // Sender plugin-side update
         _sender.Update();
@@ -142,6 +229,7 @@ void OnDisable()
         StopAllCoroutines();
         ReleaseSender();
         PrepareBuffer(0, 0);
+        PrepareDirectSource(null);
         PrepareCameraCapture(null);
     }
 
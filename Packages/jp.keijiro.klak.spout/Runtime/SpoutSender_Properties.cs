@@ -36,6 +36,48 @@ public bool keepAlpha
       { get => _keepAlpha;
         set => _keepAlpha = value; }
 
+    // HDR option: Half and float sources (and HDR cameras) are shared in the
+    // RGBAHalf/RGBAFloat formats instead of being quantized to 8 bits. Off by
+    // default, as most receivers expect an 8-bit texture.
+    [SerializeField] bool _hdr = false;
+
+    public bool hdr
+      { get => _hdr;
+        set => _hdr = value; }
+
+    // Direct copy option: In the Texture capture mode with keepAlpha enabled,
+    // a source texture in a Spout-compatible format is shared as it is,
+    // without the conversion blit. Its rows stay in Unity's bottom-up order,
+    // which is flagged in the sender info, so KlakSpout receivers flip them
+    // back. Other Spout receivers show the frames upside down.
+    [SerializeField] bool _directCopy = false;
+
+    public bool directCopy
+      { get => _directCopy;
+        set => _directCopy = value; }
+
+    #endregion
+
+    #region Multi-buffering
+
+    // Number of shared textures (1 : single buffered, 2 is raised to 3)
+    // With three or more, the sender never writes a texture that a receiver
+    // is reading. Receivers that don't support multi-buffering still get
+    // the latest frame.
+    [SerializeField, Range(1, 8)] int _bufferCount = 1;
+
+    public int bufferCount
+      { get => _bufferCount;
+        set => ChangeBufferCount(value); }
+
+    void ChangeBufferCount(int count)
+    {
+        // Sender refresh on change
+        if (_bufferCount == count) return;
+        _bufferCount = count;
+        ReleaseSender();
+    }
+
     #endregion
 
     #region Capture target
@@ -6,6 +6,7 @@
 #include <d3d11on12.h>
 #include <wrl/client.h> // for ComPtr
 #include "Spout/SpoutSenderNames.h"
+#include "Spout/SpoutTextureRing.h"
 #include "Unity/IUnityGraphics.h"
 #include "Unity/IUnityGraphicsD3D11.h"
 #include "Unity/IUnityGraphicsD3D12.h"
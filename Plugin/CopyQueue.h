@@ -0,0 +1,152 @@
+#pragma once
+
+#include "Common.h"
+#include "FencedSlotPool.h"
+#include "System.h"
+#include <vector>
+
+namespace KlakSpout {
+
+// D3D12 copy queue for senders
+//
+// The copies of a sender update are recorded into a command list and executed
+// on Unity's queue at the end of the update event, so receivers get the frame
+// in the same frame (waiting for the flush event at the beginning of the next
+// frame would make every frame one frame late). The command allocators are
+// pooled and reused when Unity's frame fence has passed their submission.
+// The resources used in a submission are kept alive until then.
+//
+// Only used from the render thread (under the plugin lock).
+class SenderCopyQueue final
+{
+public:
+
+    // Record a copy from a Unity texture into a shared texture.
+    void copy(ID3D12Resource* dest, ID3D12Resource* source)
+    {
+        if (!_recording && !begin()) return;
+
+        auto& slot = _slots[_current];
+
+        // The shared texture stays in the common state between frames.
+        barrier(dest, D3D12_RESOURCE_STATE_COMMON,
+                      D3D12_RESOURCE_STATE_COPY_DEST);
+        _list->CopyResource(dest, source);
+        barrier(dest, D3D12_RESOURCE_STATE_COPY_DEST,
+                      D3D12_RESOURCE_STATE_COMMON);
+
+        // Unity transitions the source before the execution.
+        _states.push_back({source, D3D12_RESOURCE_STATE_COPY_SOURCE,
+                                   D3D12_RESOURCE_STATE_COPY_SOURCE});
+
+        slot.resources.push_back(dest);
+        slot.resources.push_back(source);
+    }
+
+    // Execute the recorded copies (called at the end of the update event).
+    // Returns the fence value of the submission (0 if there is none).
+    uint64_t submit()
+    {
+        if (!_recording) return 0;
+        _recording = false;
+
+        auto hres = _list->Close();
+        if (FAILED(hres))
+        {
+            LogError("Close (copy queue)", "", hres);
+            _pool.retire(_current, 0);
+            _states.clear();
+            return 0;
+        }
+
+        auto fence = _system->getD3D12Interface()->ExecuteCommandList
+          (_list.Get(), static_cast<int>(_states.size()), _states.data());
+
+        _pool.retire(_current, fence);
+        _states.clear();
+        _system->senderStats.submissions++;
+        return fence;
+    }
+
+private:
+
+    struct Slot
+    {
+        WRL::ComPtr<ID3D12CommandAllocator> allocator;
+        std::vector<WRL::ComPtr<ID3D12Resource>> resources;
+    };
+
+    FencedSlotPool _pool;
+    std::vector<Slot> _slots;
+    int _current = 0;
+
+    WRL::ComPtr<ID3D12GraphicsCommandList> _list;
+    std::vector<UnityGraphicsD3D12ResourceState> _states;
+    bool _recording = false;
+
+    // Start recording with a free command allocator.
+    bool begin()
+    {
+        auto unity = _system->getD3D12Interface();
+        auto device = _system->getD3D12Device();
+        auto completed = unity->GetFrameFence()->GetCompletedValue();
+
+        bool added;
+        _current = _pool.acquire(completed, added);
+        if (added) _slots.emplace_back();
+
+        auto& slot = _slots[_current];
+        slot.resources.clear();
+
+        HRESULT hres;
+        if (!slot.allocator)
+            hres = device->CreateCommandAllocator
+              (D3D12_COMMAND_LIST_TYPE_DIRECT,
+               IID_PPV_ARGS(&slot.allocator));
+        else
+            hres = slot.allocator->Reset();
+
+        if (FAILED(hres))
+        {
+            LogError("CommandAllocator (copy queue)", "", hres);
+            slot.allocator = nullptr;
+            _pool.retire(_current, 0);
+            return false;
+        }
+
+        // The command list is created in the recording state.
+        if (!_list)
+            hres = device->CreateCommandList
+              (0, D3D12_COMMAND_LIST_TYPE_DIRECT, slot.allocator.Get(),
+               nullptr, IID_PPV_ARGS(&_list));
+        else
+            hres = _list->Reset(slot.allocator.Get(), nullptr);
+
+        if (FAILED(hres))
+        {
+            LogError("CommandList (copy queue)", "", hres);
+            _pool.retire(_current, 0);
+            return false;
+        }
+
+        _recording = true;
+        return true;
+    }
+
+    void barrier(ID3D12Resource* resource,
+                 D3D12_RESOURCE_STATES before, D3D12_RESOURCE_STATES after)
+    {
+        D3D12_RESOURCE_BARRIER barrier = {};
+        barrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+        barrier.Transition.pResource = resource;
+        barrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+        barrier.Transition.StateBefore = before;
+        barrier.Transition.StateAfter = after;
+        _list->ResourceBarrier(1, &barrier);
+    }
+};
+
+// Singleton instance (created on demand, released on device shutdown)
+inline std::unique_ptr<SenderCopyQueue> _copyQueue;
+
+} // namespace KlakSpout
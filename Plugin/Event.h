@@ -13,7 +13,9 @@ enum EventID
     event_updateSender,
     event_updateReceiver,
     event_closeSender,
-    event_closeReceiver
+    event_closeReceiver,
+    event_updateAllReceivers, // No attachment data
+    event_flushSenders        // No attachment data
 };
 
 // Render event attachment data structure
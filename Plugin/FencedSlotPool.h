@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace KlakSpout {
+
+// Fence-tracked slot pool
+//
+// A slot is in flight from retire() until the GPU passes the fence value
+// given to it. acquire() returns a slot that is free or no longer in flight,
+// or adds a new one. This only deals with the fence values, so it can be
+// tested without a device (Tests/FencedSlotPoolTest.cpp).
+class FencedSlotPool final
+{
+public:
+
+    // Index of a reusable slot, given the completed fence value.
+    // "added" tells that a new slot has been appended.
+    int acquire(uint64_t completed, bool& added)
+    {
+        for (auto i = 0u; i < _fences.size(); i++)
+        {
+            if (_fences[i] <= completed)
+            {
+                _fences[i] = InUse;
+                added = false;
+                return static_cast<int>(i);
+            }
+        }
+        _fences.push_back(InUse);
+        added = true;
+        return static_cast<int>(_fences.size()) - 1;
+    }
+
+    // Marks a slot as in flight until the fence value is reached.
+    void retire(int index, uint64_t fence) { _fences[index] = fence; }
+
+    size_t size() const { return _fences.size(); }
+
+private:
+
+    static constexpr uint64_t InUse = ~0ull;
+
+    std::vector<uint64_t> _fences;
+};
+
+} // namespace KlakSpout
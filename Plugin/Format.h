@@ -1,6 +1,7 @@
 #pragma once
 
-#include "Common.h"
+#include <dxgiformat.h>
+#include <stdint.h>
 
 namespace KlakSpout {
 
@@ -25,4 +26,76 @@ static inline Format ToFormat(DXGI_FORMAT format)
     }
 }
 
+static inline DXGI_FORMAT ToDXGIFormat(Format format)
+{
+    switch (format)
+    {
+        case Format::RGBA32:      return DXGI_FORMAT_R8G8B8A8_UNORM;
+        case Format::RGBA32_SRGB: return DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+        case Format::BGRA32:      return DXGI_FORMAT_B8G8R8A8_UNORM;
+        case Format::BGRA32_SRGB: return DXGI_FORMAT_B8G8R8A8_UNORM_SRGB;
+        case Format::RGBAHalf:    return DXGI_FORMAT_R16G16B16A16_FLOAT;
+        case Format::RGBAFloat:   return DXGI_FORMAT_R32G32B32A32_FLOAT;
+        default: return DXGI_FORMAT_UNKNOWN;
+    }
+}
+
+// Typeless group of a Spout-compatible format
+// CopyResource only works between formats in the same group.
+static inline DXGI_FORMAT ToTypeless(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+        case DXGI_FORMAT_R8G8B8A8_TYPELESS:
+        case DXGI_FORMAT_R8G8B8A8_UNORM:
+        case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+            return DXGI_FORMAT_R8G8B8A8_TYPELESS;
+        case DXGI_FORMAT_B8G8R8A8_TYPELESS:
+        case DXGI_FORMAT_B8G8R8A8_UNORM:
+        case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+            return DXGI_FORMAT_B8G8R8A8_TYPELESS;
+        case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+        case DXGI_FORMAT_R16G16B16A16_FLOAT:
+            return DXGI_FORMAT_R16G16B16A16_TYPELESS;
+        case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+        case DXGI_FORMAT_R32G32B32A32_FLOAT:
+            return DXGI_FORMAT_R32G32B32A32_TYPELESS;
+        default: return DXGI_FORMAT_UNKNOWN;
+    }
+}
+
+// Shared texture format of a sender
+//
+// The format requested by the Unity side is used when the source texture can
+// be copied into it. Otherwise the linear typed format of the source group is
+// used. Returns DXGI_FORMAT_UNKNOWN when the source can't be shared without
+// a conversion. This only depends on the format values, so it can be tested
+// without a device.
+static inline DXGI_FORMAT NegotiateFormat(Format requested, DXGI_FORMAT source)
+{
+    auto group = ToTypeless(source);
+    if (group == DXGI_FORMAT_UNKNOWN) return DXGI_FORMAT_UNKNOWN;
+
+    auto format = ToDXGIFormat(requested);
+    if (ToTypeless(format) == group) return format;
+
+    switch (group)
+    {
+        case DXGI_FORMAT_R8G8B8A8_TYPELESS:     return DXGI_FORMAT_R8G8B8A8_UNORM;
+        case DXGI_FORMAT_B8G8R8A8_TYPELESS:     return DXGI_FORMAT_B8G8R8A8_UNORM;
+        case DXGI_FORMAT_R16G16B16A16_TYPELESS: return DXGI_FORMAT_R16G16B16A16_FLOAT;
+        default:                                return DXGI_FORMAT_R32G32B32A32_FLOAT;
+    }
+}
+
+static inline unsigned int BytesPerPixel(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+        case DXGI_FORMAT_R16G16B16A16_FLOAT: return 8;
+        case DXGI_FORMAT_R32G32B32A32_FLOAT: return 16;
+        default: return 4;
+    }
+}
+
 } // namespace KlakSpout
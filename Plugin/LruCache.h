@@ -0,0 +1,63 @@
+#pragma once
+
+#include <list>
+#include <stddef.h>
+
+namespace KlakSpout {
+
+// Small least-recently-used cache with a fixed capacity
+//
+// The entries are kept in a list in the order of use, so the lookups are
+// linear. It's meant for a handful of entries (see SharedResourceCache).
+// This doesn't depend on the graphics API, so it's tested on Linux
+// (Tests/LruCacheTest.cpp).
+template <typename Key, typename Value, size_t Capacity>
+class LruCache final
+{
+public:
+
+    // Value of a key, moved to the front, or nullptr
+    Value* find(const Key& key)
+    {
+        for (auto it = _entries.begin(); it != _entries.end(); it++)
+        {
+            if (!(it->key == key)) continue;
+            _entries.splice(_entries.begin(), _entries, it);
+            return &_entries.front().value;
+        }
+        return nullptr;
+    }
+
+    // Add an entry at the front. The least recently used one is dropped
+    // when the cache is full.
+    void insert(const Key& key, const Value& value)
+    {
+        _entries.push_front(Entry{key, value});
+        if (_entries.size() > Capacity) _entries.pop_back();
+    }
+
+    // Drop the entries that match a predicate, returns the number of them
+    template <typename Predicate>
+    size_t evict(Predicate match)
+    {
+        auto count = _entries.size();
+        _entries.remove_if([&](const Entry& e) { return match(e.key); });
+        return count - _entries.size();
+    }
+
+    void clear() { _entries.clear(); }
+
+    size_t size() const { return _entries.size(); }
+
+private:
+
+    struct Entry
+    {
+        Key key;
+        Value value;
+    };
+
+    std::list<Entry> _entries;
+};
+
+} // namespace KlakSpout
@@ -1,9 +1,14 @@
 #include "Common.h"
+#include "CopyQueue.h"
 #include "Event.h"
+#include "Poller.h"
 #include "Receiver.h"
 #include "Sender.h"
+#include "Sweeper.h"
 #include "System.h"
 #include "Util.h"
+#include "Watcher.h"
+#include <algorithm>
 #include <mutex>
 
 using namespace KlakSpout;
@@ -20,7 +25,12 @@ std::mutex lock_;
 void UNITY_INTERFACE_API
   OnGraphicsDeviceEvent(UnityGfxDeviceEventType event_type)
 {
-    if (event_type == kUnityGfxDeviceEventShutdown) _system->shutdown();
+    if (event_type == kUnityGfxDeviceEventShutdown)
+    {
+        _copyQueue.reset();
+        _resourceCache.clear();
+        _system->shutdown();
+    }
 }
 
 // Render event (via IssuePluginEvent) callback
@@ -33,6 +43,8 @@ void UNITY_INTERFACE_API
     if (event_id == event_updateReceiver) data->receiver->update();
     if (event_id == event_closeSender  ) delete data->sender;
     if (event_id == event_closeReceiver) delete data->receiver;
+    if (event_id == event_updateAllReceivers) Receiver::updateAll();
+    if (event_id == event_flushSenders) Sender::flushAll();
 }
 
 } // anonymous namespace
@@ -45,10 +57,27 @@ extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API
     // System object instantiation, callback registration
     _system = std::make_unique<System>(interfaces);
     _system->getGraphics()->RegisterDeviceEventCallback(OnGraphicsDeviceEvent);
+
+    // Orphan senders are removed by the sweeper thread, not on the render
+    // thread.
+    _system->spout.SetDeferredCleanup(true);
+    _sweeper = std::make_unique<OrphanSweeper>();
+
+    // Receivers are checked on the poller thread.
+    _poller = std::make_unique<ReceiverPoller>();
 }
 
 extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UnityPluginUnload()
 {
+    // Watcher/sweeper/poller thread termination
+    _watcher.reset();
+    _sweeper.reset();
+    _poller.reset();
+
+    // Cached resources must be released before the devices.
+    _copyQueue.reset();
+    _resourceCache.clear();
+
     // System object destruction
     _system->getGraphics()->UnregisterDeviceEventCallback(OnGraphicsDeviceEvent);
     _system.reset();
@@ -56,6 +85,13 @@ extern "C" void UNITY_INTERFACE_EXPORT UNITY_INTERFACE_API UnityPluginUnload()
 
 // Plugin functions
 
+// Interface version checked by Plugin.cs to detect an outdated binary, which
+// doesn't have this function. Increment it when adding functions or events.
+extern "C" int UNITY_INTERFACE_EXPORT GetInterfaceVersion()
+{
+    return 3;
+}
+
 extern "C" UnityRenderingEventAndData UNITY_INTERFACE_EXPORT
   GetRenderEventCallback()
 {
@@ -63,14 +99,28 @@ extern "C" UnityRenderingEventAndData UNITY_INTERFACE_EXPORT
 }
 
 extern "C" Sender UNITY_INTERFACE_EXPORT *
-  CreateSender(const char* name, int width, int height)
+  CreateSender(const char* name, int width, int height, Format format,
+               int bufferCount)
+{
+    // The sender list is also read from the render thread.
+    std::lock_guard<std::mutex> guard(lock_);
+    return new Sender(name, width, height, format, bufferCount);
+}
+
+// Row order of the sender source (bottomUp : a Unity texture shared without
+// the flipping blit, see SpoutInfoBottomUp)
+extern "C" void UNITY_INTERFACE_EXPORT
+  SetSenderRowOrder(Sender* sender, int bottomUp)
 {
-    return new Sender(name, width, height);
+    std::lock_guard<std::mutex> guard(lock_);
+    sender->setBottomUp(bottomUp != 0);
 }
 
 extern "C" Receiver UNITY_INTERFACE_EXPORT *
   CreateReceiver(const char* name)
 {
+    // The receiver list is also read from the render thread.
+    std::lock_guard<std::mutex> guard(lock_);
     return new Receiver(name);
 }
 
@@ -80,11 +130,88 @@ extern "C" Receiver::InteropData UNITY_INTERFACE_EXPORT
     return receiver->getInteropData();
 }
 
+extern "C" void UNITY_INTERFACE_EXPORT
+  SetReceiverReadback(Receiver* receiver, int depth)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    receiver->setReadback(depth);
+}
+
+// Copies the latest readback frame into the buffer and returns the copied
+// size. The frame information is returned even if nothing is copied.
+extern "C" int UNITY_INTERFACE_EXPORT
+  GetReceiverReadback
+    (Receiver* receiver, void* buffer, int size, ReadbackInfo* info)
+{
+    // The receiver may be closed on the render thread, so the ring is
+    // referenced under the lock. The frame is copied without it, so that
+    // OnRenderEvent doesn't wait for the copy.
+    std::shared_ptr<ReadbackRing> ring;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        ring = receiver->getReadback();
+    }
+    if (!ring)
+    {
+        *info = {};
+        return 0;
+    }
+    return ring->read(buffer, size, *info);
+}
+
 extern "C" void UNITY_INTERFACE_EXPORT
   GetSenderNames(char*** names, int* count)
 {
     std::lock_guard<std::mutex> guard(lock_);
-    std::set<std::string> senders;
-    _system->spout.GetSenderNames(&senders);
+    auto senders = _system->spout.GetSenderNameTable();
     std::tie(*names, *count) = MarshalStringSet(senders);
 }
+
+// Names and texture info of all the senders
+// Fills up to "capacity" entries and returns the number of senders. The format
+// field is converted to KlakSpout::Format.
+extern "C" int UNITY_INTERFACE_EXPORT
+  GetSenderSnapshot(SpoutSenderSnapshot* entries, int capacity,
+                    char* names, int namesSize)
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    static constexpr SpoutLockPolicy policy = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+    auto count = _system->spout.GetSenderSnapshot
+      (entries, capacity, names, namesSize, policy);
+    for (auto i = 0; i < std::min(count, capacity); i++)
+        entries[i].format = static_cast<DWORD>
+          (ToFormat(static_cast<DXGI_FORMAT>(entries[i].format)));
+    return count;
+}
+
+// Sender list change counter
+// This starts the watcher thread on the first call. Only called from the main
+// thread, so no locking is needed for the lazy initialization.
+extern "C" uint32_t UNITY_INTERFACE_EXPORT GetSenderListVersion()
+{
+    if (!_watcher)
+        _watcher = std::make_unique<SenderListWatcher>();
+    return _watcher->getVersion();
+}
+
+// Sender counters: Dividing the wrap creations and the flushes by the frames
+// gives the per-frame rates.
+extern "C" System::SenderStats UNITY_INTERFACE_EXPORT GetSenderStats()
+{
+    std::lock_guard<std::mutex> guard(lock_);
+    return _system->senderStats;
+}
+
+extern "C" void UNITY_INTERFACE_EXPORT
+  EnableLockStats(int enable)
+{
+    SpoutLockStats::Enable(enable != 0);
+}
+
+// Copies up to "capacity" entries of the lock-wait counter table and returns
+// the number of map names in the table.
+extern "C" int UNITY_INTERFACE_EXPORT
+  GetLockStats(SpoutLockStatsData* data, int capacity)
+{
+    return SpoutLockStats::Snapshot(data, capacity);
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "Spout/SpoutSenderNames.h"
+#include "Spout/SpoutTextureRing.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace KlakSpout {
+
+// Latest sender check result of a subscribed sender name
+// The fields are guarded by the poller lock (ReceiverPoller::getLock).
+struct PollSlot
+{
+    std::string name;
+    DWORD stamp = 0; // Passed to the next check, 0 to force a full check
+    SpoutSenderQuery result = {};
+    bool fresh = false; // Set when the result has changed
+
+    // Ring map of a multi-buffered sender (see Spout/SpoutTextureRing.h),
+    // opened by the poller with a new result (null if there is none)
+    std::shared_ptr<SpoutSharedMemory> ringMap;
+};
+
+// Background thread that checks the subscribed senders
+//
+// All the registry access and the cross-process mutex waits for receivers run
+// on this thread with its own spoutSenderNames instance. The render thread
+// only picks up the results, and it doesn't wait for the poller lock (see
+// ReceiverSubscription), so a stalled sender mutex can't stall rendering.
+class ReceiverPoller final
+{
+public:
+
+    ReceiverPoller() : _thread(&ReceiverPoller::run, this) {}
+
+    ~ReceiverPoller()
+    {
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _stop = true;
+        }
+        _signal.notify_one();
+        _thread.join();
+    }
+
+    std::shared_ptr<PollSlot> subscribe(const char* name)
+    {
+        auto slot = std::make_shared<PollSlot>();
+        slot->name = name;
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _slots.push_back(slot);
+        }
+        _signal.notify_one(); // Check the new name right away
+        return slot;
+    }
+
+    void unsubscribe(const std::shared_ptr<PollSlot>& slot)
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        _slots.erase(std::find(_slots.begin(), _slots.end(), slot));
+    }
+
+    std::mutex& getLock() { return _lock; }
+
+private:
+
+    static constexpr auto Interval = std::chrono::milliseconds(4);
+
+    std::mutex _lock;
+    std::condition_variable _signal;
+    std::vector<std::shared_ptr<PollSlot>> _slots;
+    bool _stop = false;
+
+    std::thread _thread; // Started last in the initializer list
+
+    void run()
+    {
+        spoutSenderNames spout;
+
+        // Crashed senders are left to the sweeper.
+        spout.SetDeferredCleanup(true);
+
+        // Working copies (reused every cycle)
+        std::vector<std::shared_ptr<PollSlot>> slots;
+        std::vector<std::string> names;
+        std::vector<SpoutSenderQuery> queries;
+        std::vector<std::shared_ptr<SpoutSharedMemory>> ringMaps;
+
+        std::unique_lock<std::mutex> lock(_lock);
+
+        while (!_stop)
+        {
+            // Copy the subscriptions, then check them without the lock.
+            slots = _slots;
+            names.resize(slots.size());
+            queries.resize(slots.size());
+            ringMaps.resize(slots.size());
+            for (size_t i = 0; i < slots.size(); i++)
+            {
+                names[i] = slots[i]->name;
+                queries[i] = {};
+                queries[i].name = names[i].c_str();
+                queries[i].stamp = slots[i]->stamp;
+                ringMaps[i] = slots[i]->ringMap;
+            }
+
+            lock.unlock();
+
+            spout.CheckSenders(queries.data(),
+              static_cast<int>(queries.size()), WaitPolicy);
+
+            // The ring maps are looked up here too, so that the render
+            // thread doesn't open a map on every sender change. An open map
+            // is kept, as multi-buffered senders change their info on every
+            // frame.
+            for (size_t i = 0; i < slots.size(); i++)
+                openRingMap(queries[i], ringMaps[i]);
+
+            lock.lock();
+
+            for (size_t i = 0; i < slots.size(); i++)
+                publish(*slots[i], queries[i], ringMaps[i]);
+
+            // Drop the references before waiting.
+            slots.clear();
+            ringMaps.clear();
+
+            _signal.wait_for(lock, Interval);
+        }
+    }
+
+    // Ring map of a sender with a new result (null if there is none)
+    // The current map is kept while it has the advertised handle in it.
+    static void openRingMap(const SpoutSenderQuery& query,
+                            std::shared_ptr<SpoutSharedMemory>& map)
+    {
+        if (query.result == SPOUT_CHECK_UNCHANGED) return;
+        if (query.result == SPOUT_CHECK_BUSY) return;
+        if (query.result != SPOUT_CHECK_SUCCESS) { map = nullptr; return; }
+        if (map && hasHandle(*map, query.handle)) return;
+        map = std::make_shared<SpoutSharedMemory>();
+        auto name = std::string(query.name) + "_ring";
+        if (!map->Open(name.c_str())) map = nullptr;
+    }
+
+    static bool hasHandle(SpoutSharedMemory& map, HANDLE handle)
+    {
+        SpoutTextureRing ring;
+        ring.Attach(map.Buffer());
+        for (auto i = 0; i < ring.SlotCount(); i++)
+            if (LongToHandle(static_cast<LONG>(ring.Handle(i))) == handle)
+                return true;
+        return false;
+    }
+
+    static void publish(PollSlot& slot, const SpoutSenderQuery& query,
+                        std::shared_ptr<SpoutSharedMemory>& ringMap)
+    {
+        if (query.result == SPOUT_CHECK_UNCHANGED) return;
+        if (query.result == SPOUT_CHECK_BUSY) return;
+
+        // Report a missing sender once. A new slot starts as missing.
+        if (query.result == SPOUT_CHECK_FAILED &&
+            slot.result.result == SPOUT_CHECK_FAILED && !slot.fresh) return;
+
+        slot.stamp = query.stamp;
+        slot.result = query;
+        slot.ringMap = std::move(ringMap);
+        slot.fresh = true;
+    }
+
+    // The poller can wait for the map locks.
+    static constexpr SpoutLockPolicy WaitPolicy
+      = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+};
+
+// Singleton instance
+inline std::unique_ptr<ReceiverPoller> _poller;
+
+} // namespace KlakSpout
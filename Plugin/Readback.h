@@ -0,0 +1,251 @@
+#pragma once
+
+#include "Common.h"
+#include "Format.h"
+#include "LruCache.h"
+#include "System.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace KlakSpout {
+
+// Readback frame information
+// Should match with Klak.Spout.SpoutReadbackInfo (SpoutReceiver.cs)
+struct ReadbackInfo
+{
+    uint64_t stamp; // Frame number (starts at 1, 0 : no frame)
+    unsigned int width, height;
+    unsigned int rowPitch; // Bytes per row (rows are tightly packed)
+    Format format;
+};
+
+// CPU readback ring of a received texture
+//
+// Every frame the received texture is copied into the next one of a ring of
+// staging textures, and the oldest one is mapped once the ring is full, so the
+// CPU reads a frame that is (depth - 1) frames old and never waits for the
+// GPU. If a staging texture is still in use by the GPU, the map is retried on
+// the next frame; the frame is dropped if the ring overflows, so the stamps
+// of the published frames only increase.
+//
+// The staging textures are created on the D3D11 device (D3D11On12 in the
+// D3D12 mode), which opens the share handle by itself. A multi-buffered
+// sender has a handle per ring slot, so the opened sources are cached by
+// handle, and the ring is only reset when the source size or format changes.
+//
+// copy() runs on the render thread. read() may be called from any thread
+// without the plugin lock, holding a reference to the ring, which is then
+// released on that thread.
+class ReadbackRing final
+{
+public:
+
+    ReadbackRing(int depth) : _slots(std::max(depth, 2)) {}
+
+    // Copy the current frame of a shared texture and publish finished frames
+    void copy(HANDLE handle)
+    {
+        if (!handle)
+        {
+            // Sender gone: Its textures aren't kept alive.
+            _sources.clear();
+            _source = nullptr;
+            _handle = nullptr;
+            return;
+        }
+
+        if (handle != _handle || !_source) select(handle);
+        if (!_source) return;
+
+        auto ctx = _system->getD3D11Context();
+        auto depth = _slots.size();
+
+        // Drop the oldest frame if it hasn't been mapped yet.
+        if (_pending == depth)
+        {
+            _read = (_read + 1) % depth;
+            _pending--;
+        }
+
+        // GPU copy into the next staging texture
+        auto& slot = _slots[_write];
+        ctx->CopyResource(slot.texture.Get(), _source.Get());
+        slot.stamp = ++_frameCount;
+        _write = (_write + 1) % depth;
+        _pending++;
+
+        // D3D11On12 only submits the copy on a flush.
+        if (_system->isD3D12) ctx->Flush();
+
+        // Map the oldest frame if it's (depth - 1) frames old.
+        if (_pending == depth) map(ctx.Get());
+
+        // Publish a finished frame if the reader doesn't hold the buffer.
+        if (_backStamp > 0)
+        {
+            std::unique_lock<std::mutex> lock(_frontLock, std::try_to_lock);
+            if (lock)
+            {
+                std::swap(_front, _back);
+                _frontInfo = _backInfo;
+                _frontInfo.stamp = _backStamp;
+                _backStamp = 0;
+            }
+        }
+    }
+
+    // Copy the latest frame into a buffer. The frame information is always
+    // returned, so the caller can size the buffer. Returns the copied size
+    // (0 if there is no frame yet or the buffer is too small).
+    int read(void* buffer, int size, ReadbackInfo& info)
+    {
+        std::lock_guard<std::mutex> guard(_frontLock);
+        info = _frontInfo;
+        if (info.stamp == 0 || !buffer) return 0;
+        if (size < static_cast<int>(_front.size())) return 0;
+        std::memcpy(buffer, _front.data(), _front.size());
+        return static_cast<int>(_front.size());
+    }
+
+private:
+
+    struct Slot
+    {
+        WRL::ComPtr<ID3D11Texture2D> texture;
+        uint64_t stamp;
+    };
+
+    std::vector<Slot> _slots;
+    size_t _write = 0, _read = 0, _pending = 0;
+    uint64_t _frameCount = 0;
+
+    HANDLE _handle = nullptr;
+    WRL::ComPtr<ID3D11Texture2D> _source;
+    LruCache<HANDLE, WRL::ComPtr<ID3D11Texture2D>, SpoutRingMaxSlots + 1> _sources;
+    D3D11_TEXTURE2D_DESC _desc = {};
+
+    // Back buffer (render thread only)
+    std::vector<uint8_t> _back;
+    ReadbackInfo _backInfo = {};
+    uint64_t _backStamp = 0;
+
+    // Front buffer (guarded by _frontLock)
+    std::mutex _frontLock;
+    std::vector<uint8_t> _front;
+    ReadbackInfo _frontInfo = {};
+
+    // Select the source of a share handle. A failed open is retried on the
+    // next frame (only logged once).
+    void select(HANDLE handle)
+    {
+        auto retry = handle == _handle;
+        _handle = handle;
+        _source = nullptr;
+
+        auto cached = _sources.find(handle);
+        if (cached)
+        {
+            _source = *cached;
+        }
+        else
+        {
+            auto hres = _system->getD3D11Device()
+              ->OpenSharedResource(handle, IID_PPV_ARGS(&_source));
+            if (FAILED(hres))
+            {
+                if (!retry) LogError("OpenSharedResource (readback)", "", hres);
+                return;
+            }
+        }
+
+        D3D11_TEXTURE2D_DESC desc;
+        _source->GetDesc(&desc);
+
+        // Same size and format: The ring goes on with the new source.
+        if (_slots[0].texture && desc.Width == _desc.Width &&
+            desc.Height == _desc.Height && desc.Format == _desc.Format)
+        {
+            if (!cached) _sources.insert(handle, _source);
+            return;
+        }
+
+        // The cached sources of the previous size are released.
+        _sources.clear();
+        _sources.insert(handle, _source);
+        _desc = desc;
+
+        auto hres = reset();
+        if (FAILED(hres))
+        {
+            if (!retry) LogError("CreateTexture2D (readback)", "", hres);
+            _source = nullptr;
+        }
+    }
+
+    // Recreate the staging textures for the source description.
+    HRESULT reset()
+    {
+        _write = _read = _pending = 0;
+        for (auto& slot : _slots) slot.texture = nullptr;
+
+        D3D11_TEXTURE2D_DESC desc = _desc;
+        desc.MipLevels = 1;
+        desc.ArraySize = 1;
+        desc.SampleDesc.Count = 1;
+        desc.SampleDesc.Quality = 0;
+        desc.Usage = D3D11_USAGE_STAGING;
+        desc.BindFlags = 0;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
+        desc.MiscFlags = 0;
+
+        auto device = _system->getD3D11Device();
+        for (auto& slot : _slots)
+        {
+            auto hres = device->CreateTexture2D(&desc, nullptr, &slot.texture);
+            if (FAILED(hres))
+            {
+                _slots[0].texture = nullptr; // Recreated on the next select
+                return hres;
+            }
+        }
+        return S_OK;
+    }
+
+    // Map the oldest pending frame into the back buffer without waiting.
+    void map(ID3D11DeviceContext* ctx)
+    {
+        auto& slot = _slots[_read];
+
+        D3D11_MAPPED_SUBRESOURCE mapped;
+        auto hres = ctx->Map(slot.texture.Get(), 0, D3D11_MAP_READ,
+                             D3D11_MAP_FLAG_DO_NOT_WAIT, &mapped);
+        if (hres == DXGI_ERROR_WAS_STILL_DRAWING) return; // Retry later
+        if (FAILED(hres))
+        {
+            LogError("Map (readback)", "", hres);
+            return;
+        }
+
+        // Row copy into the tightly packed back buffer
+        auto pitch = _desc.Width * BytesPerPixel(_desc.Format);
+        _back.resize(static_cast<size_t>(pitch) * _desc.Height);
+        auto src = static_cast<const uint8_t*>(mapped.pData);
+        for (auto y = 0u; y < _desc.Height; y++)
+            std::memcpy(&_back[y * pitch], src + y * mapped.RowPitch, pitch);
+
+        ctx->Unmap(slot.texture.Get(), 0);
+
+        _backInfo.width = _desc.Width;
+        _backInfo.height = _desc.Height;
+        _backInfo.rowPitch = pitch;
+        _backInfo.format = ToFormat(_desc.Format);
+        _backStamp = slot.stamp;
+
+        _read = (_read + 1) % _slots.size();
+        _pending--;
+    }
+};
+
+} // namespace KlakSpout
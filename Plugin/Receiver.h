@@ -3,58 +3,293 @@
 #include "Common.h"
 #include "System.h"
 #include "Format.h"
+#include "Poller.h"
+#include "Readback.h"
+#include "ResourceCache.h"
+#include <algorithm>
+#include <vector>
 
 namespace KlakSpout {
 
-// DX11/12 compatible Spout receiver class
-class Receiver final
+// Sender polling state shared by the receivers of a sender name
+//
+// Receivers with the same sender name share a subscription, so the registry
+// polling and the shared resource open are done once per distinct sender.
+// The polling itself runs on the poller thread (Poller.h). The render thread
+// only applies the results.
+class ReceiverSubscription final
 {
 public:
 
-    Receiver(const char* name)
-      : _name(name) {}
+    // Subscription for a sender name, created on the first reference.
+    // This modifies the instance list, so it has to be called with the
+    // plugin lock held (as well as release).
+    static ReceiverSubscription* acquire(const char* name)
+    {
+        for (auto instance : _instances)
+        {
+            if (instance->_name != name) continue;
+            instance->_references++;
+            return instance;
+        }
+        return new ReceiverSubscription(name);
+    }
 
-    ~Receiver()
+    void release()
     {
-        _texture = nullptr;
+        if (--_references == 0) delete this;
     }
 
     void update()
     {
-        // Search the Spout name list.
-        unsigned int width, height;
-        HANDLE handle;
-        DWORD format;
-        auto res = _system->spout
-          .CheckSender(_name.c_str(), width, height, handle, format);
+        // Don't wait for the poller. The result is picked up on the next
+        // update if the poller is publishing right now.
+        {
+            std::unique_lock<std::mutex> lock
+              (_poller->getLock(), std::try_to_lock);
+            if (lock) take();
+        }
+        updateRing();
+    }
+
+    // Apply the new results of all the subscriptions
+    static void updateAll()
+    {
+        {
+            std::unique_lock<std::mutex> lock
+              (_poller->getLock(), std::try_to_lock);
+            if (lock) for (auto instance : _instances) instance->take();
+        }
+
+        // Multi-buffered senders
+        for (auto instance : _instances) instance->updateRing();
+
+        // CPU readback of the current frames
+        for (auto instance : _instances)
+            if (instance->_readback) instance->_readback->copy(instance->_handle);
+    }
+
+    // CPU readback users (called with the plugin lock held)
+    // The ring is created by the first user with the given depth.
+    void addReadback(int depth)
+    {
+        if (_readbackUsers++ == 0)
+            _readback = std::make_shared<ReadbackRing>(depth);
+    }
+
+    void removeReadback()
+    {
+        if (--_readbackUsers == 0) _readback.reset();
+    }
+
+    std::shared_ptr<ReadbackRing> getReadback() const { return _readback; }
+
+    unsigned int getWidth() const { return _width; }
+    unsigned int getHeight() const { return _height; }
+    Format getFormat() const { return _format; }
+    bool isBottomUp() const { return _bottomUp; }
+    IUnknown* getTexture() const { return _texture.Get(); }
+
+private:
+
+    ReceiverSubscription(const char* name)
+      : _name(name), _slot(_poller->subscribe(name))
+    {
+        _instances.push_back(this);
+    }
+
+    ~ReceiverSubscription()
+    {
+        _poller->unsubscribe(_slot);
+        _instances.erase
+          (std::find(_instances.begin(), _instances.end(), this));
+        closeRing();
+        _texture = nullptr;
+    }
+
+    // Apply the poller result if it's new (with the poller lock held)
+    void take()
+    {
+        if (!_slot->fresh) return;
+        _slot->fresh = false;
+        apply(_slot->result);
+        // Have the poller report the sender again to retry the open.
+        if (!_texture) _slot->stamp = 0;
+    }
+
+    // Apply the result of a sender check
+    void apply(const SpoutSenderQuery& query)
+    {
+        _bottomUp = query.result == SPOUT_CHECK_SUCCESS &&
+                    (query.flags & SpoutInfoBottomUp);
+
+        // Multi-buffered sender: The texture is selected in updateRing.
+        if (query.result == SPOUT_CHECK_SUCCESS && openRing()) return;
+        closeRing();
 
         // Do nothing further if the current texture is valid.
-        if (res && _texture && _width == width && _height == height) return;
+        if (query.result == SPOUT_CHECK_SUCCESS && _texture &&
+            _handle == query.handle &&
+            _width == query.width && _height == query.height) return;
+
+        // The previous texture is gone when the sender is closed or shares
+        // another handle, so it's dropped from the cache.
+        if (query.result != SPOUT_CHECK_SUCCESS || query.handle != _handle)
+            _resourceCache.evict(_handle);
 
-        HRESULT hres;
+        // Handle -> D3D11Resource/D3D12Resource
+        auto hres = _resourceCache.open(query.handle, _texture);
 
-        if (_system->isD3D12)
+        _handle = query.handle;
+        _width = query.width;
+        _height = query.height;
+        _format = ToFormat(static_cast<DXGI_FORMAT>(query.format));
+
+        if (FAILED(hres)) LogError("OpenSharedResource", _name, hres);
+    }
+
+    // Ring map of a multi-buffered sender (see Spout/SpoutTextureRing.h)
+    // The map is opened by the poller (with the poller lock held).
+    bool openRing()
+    {
+        if (!_ring.IsValid())
         {
-            // Handle -> D3D12Resource
-            WRL::ComPtr<ID3D12Resource> resource;
-            hres = _system->getD3D12Device()
-              ->OpenSharedHandle(handle, IID_PPV_ARGS(&resource));
-            _texture = resource;
+            if (!_slot->ringMap) return false;
+            _ringMap = _slot->ringMap;
+            _ring.Attach(_ringMap->Buffer());
         }
-        else
+        return _ring.IsValid();
+    }
+
+    void closeRing()
+    {
+        _ring.Release(_ringSlot, _ringEpoch);
+        _ringSlot = -1;
+        _ring.Attach(nullptr);
+        _ringMap = nullptr;
+        evictRingHandles();
+    }
+
+    // Drop the slot textures of the ring from the cache (the ring is gone or
+    // has been set up again with new textures) and keep the current handles.
+    void evictRingHandles()
+    {
+        for (auto i = 0; i < SpoutRingMaxSlots; i++)
         {
-            // Handle -> D3D11Resource
-            WRL::ComPtr<ID3D11Resource> resource;
-            hres = _system->getD3D11Device()
-              ->OpenSharedResource(handle, IID_PPV_ARGS(&resource));
-            _texture = resource;
+            _resourceCache.evict(LongToHandle(static_cast<LONG>(_ringHandles[i])));
+            _ringHandles[i] = _ring.Handle(i);
         }
+    }
 
-        _width = width;
-        _height = height;
-        _format = ToFormat(static_cast<DXGI_FORMAT>(format));
+    // Hold the latest ring slot, so that the sender doesn't write into it
+    // while it's in use. The previous slot is released after that.
+    void updateRing()
+    {
+        if (!_ring.IsValid()) return;
 
-        if (FAILED(hres)) LogError("OpenSharedResource", _name, hres);
+        auto epoch = _ringEpoch;
+        auto slot = _ring.AcquireLatest(_ringEpoch);
+        _ring.Release(_ringSlot, epoch);
+        _ringSlot = slot;
+        if (_ringEpoch != epoch) evictRingHandles();
+        if (slot < 0) return;
+
+        auto handle = LongToHandle(static_cast<LONG>(_ring.Handle(slot)));
+        if (handle == _handle && _texture) return;
+
+        auto hres = _resourceCache.open(handle, _texture);
+        _handle = handle;
+
+        if (FAILED(hres))
+        {
+            LogError("OpenSharedResource (ring)", _name, hres);
+            _texture = nullptr;
+            return;
+        }
+
+        // The size may change before the sender info is polled again,
+        // so it's taken from the texture itself.
+        WRL::ComPtr<ID3D12Resource> d3d12;
+        WRL::ComPtr<ID3D11Texture2D> d3d11;
+        if (SUCCEEDED(_texture.As(&d3d12)))
+        {
+            auto desc = d3d12->GetDesc();
+            _width = static_cast<unsigned int>(desc.Width);
+            _height = desc.Height;
+            _format = ToFormat(desc.Format);
+        }
+        else if (SUCCEEDED(_texture.As(&d3d11)))
+        {
+            D3D11_TEXTURE2D_DESC desc;
+            d3d11->GetDesc(&desc);
+            _width = desc.Width;
+            _height = desc.Height;
+            _format = ToFormat(desc.Format);
+        }
+    }
+
+    // All subscription instances (used by acquire and updateAll)
+    inline static std::vector<ReceiverSubscription*> _instances;
+
+    std::string _name;
+    int _references = 1;
+    std::shared_ptr<PollSlot> _slot;
+    HANDLE _handle = nullptr;
+    unsigned int _width = 0, _height = 0;
+    Format _format = Format::Unknown;
+    bool _bottomUp = false; // Rows in bottom-up order (SpoutInfoBottomUp)
+    WRL::ComPtr<IUnknown> _texture;
+    std::shared_ptr<SpoutSharedMemory> _ringMap;
+    SpoutTextureRing _ring;
+    int _ringSlot = -1;
+    uint32_t _ringEpoch = 0;
+    uint32_t _ringHandles[SpoutRingMaxSlots] = {};
+    std::shared_ptr<ReadbackRing> _readback;
+    int _readbackUsers = 0;
+};
+
+// DX11/12 compatible Spout receiver class
+class Receiver final
+{
+public:
+
+    // The constructor and the destructor modify the subscription list, so
+    // they have to be called with the plugin lock held.
+    Receiver(const char* name)
+      : _subscription(ReceiverSubscription::acquire(name)) {}
+
+    ~Receiver()
+    {
+        if (_readback) _subscription->removeReadback();
+        _subscription->release();
+    }
+
+    void update()
+    {
+        _subscription->update();
+    }
+
+    // Update all the receivers (see ReceiverSubscription::updateAll)
+    static void updateAll()
+    {
+        ReceiverSubscription::updateAll();
+    }
+
+    // CPU readback with a ring of the given depth (0 : disabled)
+    // Called with the plugin lock held.
+    void setReadback(int depth)
+    {
+        if (_readback) _subscription->removeReadback();
+        _readback = depth > 0;
+        if (_readback) _subscription->addReadback(depth);
+    }
+
+    // Readback ring (null if disabled), called with the plugin lock held
+    // The reference keeps the ring alive while the frame is read without
+    // the lock (see ReadbackRing::read).
+    std::shared_ptr<ReadbackRing> getReadback() const
+    {
+        return _readback ? _subscription->getReadback() : nullptr;
     }
 
     // Receiver interop data structure
@@ -64,21 +299,23 @@ public:
         unsigned int width, height;
         Format format;
         void* texture_pointer;
+        int bottom_up; // Rows in bottom-up order (the receiver flips them)
     };
 
     InteropData getInteropData() const
     {
         return InteropData
-          { .width = _width, .height = _height, .format = _format,
-            .texture_pointer = _texture.Get() };
+          { .width = _subscription->getWidth(),
+            .height = _subscription->getHeight(),
+            .format = _subscription->getFormat(),
+            .texture_pointer = _subscription->getTexture(),
+            .bottom_up = _subscription->isBottomUp() };
     }
 
 private:
 
-    std::string _name;
-    unsigned int _width, _height;
-    Format _format;
-    WRL::ComPtr<IUnknown> _texture;
+    ReceiverSubscription* _subscription;
+    bool _readback = false;
 };
 
 } // namespace KlakSpout
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Common.h"
+#include "System.h"
+#include "LruCache.h"
+
+namespace KlakSpout {
+
+// Cache of shared resources opened from Spout share handles
+//
+// Switching a receiver back to a recently used source (or a sender back to a
+// recently used size) reuses the resource opened before instead of calling
+// OpenSharedResource/OpenSharedHandle again. The entries are keyed by the
+// device and the handle, and the least recently used one is dropped when the
+// cache is full. Receivers hold their own references, so dropping an entry
+// doesn't affect a resource in use.
+//
+// A cached resource keeps the sender texture alive, so the receivers evict
+// the handles they see go away (a sender closed or resized). The handle
+// value can't be reused by another texture while it's in the cache.
+//
+// Only used from the render thread (under the plugin lock).
+class SharedResourceCache final
+{
+public:
+
+    HRESULT open(HANDLE handle, WRL::ComPtr<IUnknown>& resource)
+    {
+        WRL::ComPtr<IUnknown> device;
+        if (_system->isD3D12)
+            device = _system->getD3D12Device();
+        else
+            device = _system->getD3D11Device();
+
+        // Cache hit
+        if (auto cached = _entries.find(Key{device.Get(), handle}))
+        {
+            resource = *cached;
+            return S_OK;
+        }
+
+        // Cache miss: Open the handle.
+        HRESULT hres;
+        if (_system->isD3D12)
+        {
+            // Handle -> D3D12Resource
+            WRL::ComPtr<ID3D12Resource> d3d12;
+            hres = _system->getD3D12Device()
+              ->OpenSharedHandle(handle, IID_PPV_ARGS(&d3d12));
+            resource = d3d12;
+        }
+        else
+        {
+            // Handle -> D3D11Resource
+            WRL::ComPtr<ID3D11Resource> d3d11;
+            hres = _system->getD3D11Device()
+              ->OpenSharedResource(handle, IID_PPV_ARGS(&d3d11));
+            resource = d3d11;
+        }
+
+        if (SUCCEEDED(hres)) _entries.insert(Key{device.Get(), handle}, resource);
+
+        return hres;
+    }
+
+    // Drop the entries of a handle that is no longer shared
+    void evict(HANDLE handle)
+    {
+        if (!handle) return;
+        _entries.evict([=](const Key& key) { return key.handle == handle; });
+    }
+
+    // Drop all the entries (on device shutdown)
+    void clear()
+    {
+        _entries.clear();
+    }
+
+private:
+
+    struct Key
+    {
+        IUnknown* device; // Only for comparison
+        HANDLE handle;
+
+        bool operator == (const Key& other) const
+        {
+            return device == other.device && handle == other.handle;
+        }
+    };
+
+    LruCache<Key, WRL::ComPtr<IUnknown>, 16> _entries;
+};
+
+// Singleton instance
+inline SharedResourceCache _resourceCache;
+
+} // namespace KlakSpout
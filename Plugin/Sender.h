@@ -1,7 +1,11 @@
 #pragma once
 
 #include "Common.h"
+#include "CopyQueue.h"
 #include "System.h"
+#include "Format.h"
+#include <algorithm>
+#include <vector>
 
 namespace KlakSpout {
 
@@ -10,23 +14,47 @@ class Sender final
 {
 public:
 
-    Sender(const char* name, int width, int height)
-      : _name(name), _width(width), _height(height) {}
+    Sender(const char* name, int width, int height, Format format,
+           int bufferCount)
+      : _name(name), _width(width), _height(height), _format(format),
+        _bufferCount(bufferCount < 2 ? 1 :
+                     std::clamp(bufferCount, 3, SpoutRingMaxSlots))
+    {
+        _instances.push_back(this);
+    }
 
     ~Sender()
     {
+        _instances.erase
+          (std::find(_instances.begin(), _instances.end(), this));
+
         if (_texture)
         {
             _system->spout.ReleaseSenderName(_name.c_str());
-            _texture = nullptr;
+            _texture = {};
+            _slots.clear();
         }
     }
 
-    void update(IUnknown* source)
+    // Row order of the source (see SpoutInfoBottomUp)
+    // Set with the plugin lock held, usually before the first update.
+    void setBottomUp(bool bottomUp)
     {
-        // Lazy initialization
-        if (!_texture) initialize();
+        _bottomUp = bottomUp;
+        if (_texture)
+            _system->spout.SetSenderRowOrder(_name.c_str(), bottomUp);
+    }
+
+    // Flush the recorded copies of all the senders (see System::flush) and
+    // publish the ring slots that are done.
+    static void flushAll()
+    {
+        _system->flush();
+        for (auto instance : _instances) instance->publishCompleted();
+    }
 
+    void update(IUnknown* source)
+    {
         WRL::ComPtr<IUnknown> unknown(source);
 
         if (_system->isD3D12)
@@ -34,30 +62,384 @@ public:
             // DX12: Texture update
             WRL::ComPtr<ID3D12Resource> d3d12;
             unknown.As(&d3d12);
-            updateTexture(d3d12.Get());
+            if (!d3d12) return;
+
+            auto desc = d3d12->GetDesc();
+            if (!prepare(static_cast<int>(desc.Width), desc.Height,
+                         desc.Format)) return;
+
+            if (_slots.empty())
+            {
+                updateTexture(_texture, d3d12.Get(), desc);
+                // Native path: The copy is submitted right away.
+                if (_copyQueue) _copyQueue->submit();
+                return;
+            }
+
+            auto slot = beginWrite();
+            if (slot < 0) return;
+            if (!updateTexture(_slots[slot], d3d12.Get(), desc)) return;
+
+            // Native path: The submission is tracked with its fence value.
+            if (_slots[slot].d3d12)
+            {
+                auto fence = _copyQueue->submit();
+                if (fence > 0) endWrite(slot, fence);
+            }
+            else
+            {
+                endWrite(slot, 0);
+            }
         }
         else
         {
             // DX11: Texture update
-            WRL::ComPtr<ID3D11Resource> d3d11;
+            WRL::ComPtr<ID3D11Texture2D> d3d11;
             unknown.As(&d3d11);
-            updateTexture(d3d11.Get());
+            if (!d3d11) return;
+
+            D3D11_TEXTURE2D_DESC desc;
+            d3d11->GetDesc(&desc);
+            if (!prepare(desc.Width, desc.Height, desc.Format)) return;
+
+            if (_slots.empty())
+            {
+                updateTexture(_texture, d3d11.Get());
+                return;
+            }
+
+            auto slot = beginWrite();
+            if (slot < 0) return;
+            updateTexture(_slots[slot], d3d11.Get());
+            endWrite(slot, 0);
         }
     }
 
 private:
 
+    // Number of shared textures kept for reuse after a resize
+    static constexpr size_t PoolSize = 2;
+
+    // Shared texture
+    // It's created on the D3D11 device to get a Spout-compatible (non-NT)
+    // share handle. In the D3D12 mode, it's also opened on the D3D12 device,
+    // so that the copy can be recorded on Unity's queue.
+    struct SharedTexture
+    {
+        WRL::ComPtr<ID3D11Texture2D> d3d11;
+        WRL::ComPtr<ID3D12Resource> d3d12;
+        HANDLE handle;
+
+        explicit operator bool() const { return d3d11 != nullptr; }
+    };
+
+    // All sender instances (used by flushAll)
+    inline static std::vector<Sender*> _instances;
+
     std::string _name;
     int _width, _height;
-    WRL::ComPtr<ID3D11Texture2D> _texture;
+    Format _format;
+    SharedTexture _texture = {}; // Advertised in the sender info
+    std::vector<SharedTexture> _pool;
+    bool _failed = false;
+    bool _bottomUp = false;
+
+    // Multi-buffering (see Spout/SpoutTextureRing.h)
+    // With three or more buffers, every frame is copied into a ring slot
+    // that no receiver holds. The slot is published as the latest one in the
+    // ring map once the GPU has finished the copy, and it's also advertised
+    // in the sender info, so receivers that don't know about the ring get
+    // the latest frame (from a handle that changes every frame).
+    int _bufferCount;
+    std::vector<SharedTexture> _slots;
+    SpoutSharedMemory _ringMap;
+    SpoutTextureRing _ring;
+
+    // Ring slots being written, oldest first
+    // A write is done when Unity's frame fence passes its fence value
+    // (native D3D12 path) or when the event query of the slot has ended
+    // (D3D11 and D3D11On12).
+    struct PendingWrite { int slot; uint64_t fence; };
+    std::vector<PendingWrite> _pending;
+    std::vector<WRL::ComPtr<ID3D11Query>> _queries; // Per slot
 
-    void initialize()
+    DXGI_FORMAT _sharedFormat = DXGI_FORMAT_UNKNOWN;
+    DXGI_FORMAT _rejectedFormat = DXGI_FORMAT_UNKNOWN; // Reported once
+
+    // D3D11On12 wrapper of the source resource
+    // It's reused while the source pointer, its description and the device
+    // stay the same.
+    WRL::ComPtr<ID3D11Resource> _wrap;
+    WRL::ComPtr<ID3D12Resource> _wrapSource;
+    WRL::ComPtr<ID3D11On12Device> _wrapDevice;
+    D3D12_RESOURCE_DESC _wrapDesc = {};
+
+    // Lazy initialization and resize
+    // A source format change that changes the shared format is handled as
+    // a resize too, as CopyResource can't convert between format groups.
+    // Returns false while the shared texture doesn't match the source.
+    bool prepare(int width, int height, DXGI_FORMAT sourceFormat)
+    {
+        if (_failed) return false;
+        if (!_texture)
+        {
+            _width = width;
+            _height = height;
+            initialize(sourceFormat);
+        }
+        else if (width != _width || height != _height ||
+                 NegotiateFormat(_format, sourceFormat) != _sharedFormat)
+            resize(width, height, sourceFormat);
+        return _texture && width == _width && height == _height &&
+               NegotiateFormat(_format, sourceFormat) == _sharedFormat;
+    }
+
+    void initialize(DXGI_FORMAT sourceFormat)
+    {
+        // Shared texture format: The source format is kept, so that the
+        // texture can be copied without conversion.
+        auto format = NegotiateFormat(_format, sourceFormat);
+
+        if (format == DXGI_FORMAT_UNKNOWN)
+        {
+            LogError("Unsupported source format", _name, sourceFormat);
+            _failed = true;
+            return;
+        }
+
+        // Multi-buffering: The first slot is advertised until a frame is
+        // published.
+        std::vector<SharedTexture> slots;
+        if (createSlots(_width, _height, format, slots))
+            _texture = slots.empty() ?
+              createTexture(_width, _height, format) : slots[0];
+
+        if (!_texture)
+        {
+            _failed = true;
+            return;
+        }
+
+        _sharedFormat = format;
+
+        // The ring is published before the sender, so that receivers find
+        // it on the first check.
+        _slots = std::move(slots);
+        publishRing();
+
+        // Create a Spout sender object for the shared texture.
+        auto res = _system->spout.CreateSender
+          (_name.c_str(), _width, _height, _texture.handle, format);
+
+        if (!res) LogError("CreateSender", _name, 0);
+
+        if (res && _bottomUp)
+            _system->spout.SetSenderRowOrder(_name.c_str(), true);
+    }
+
+    // Resize: The sender stays registered. A texture of the new size is
+    // swapped in and published with UpdateSender, so that receivers only
+    // reopen the texture instead of reconnecting. All the new textures are
+    // created before anything is replaced, so the current ones stay in use
+    // if that fails.
+    void resize(int width, int height, DXGI_FORMAT sourceFormat)
+    {
+        auto format = NegotiateFormat(_format, sourceFormat);
+
+        // Unsupported source: The current texture is kept.
+        if (format == DXGI_FORMAT_UNKNOWN)
+        {
+            if (sourceFormat != _rejectedFormat)
+                LogError("Unsupported source format", _name, sourceFormat);
+            _rejectedFormat = sourceFormat;
+            return;
+        }
+
+        // Multi-buffering: The whole ring is replaced, and the first slot
+        // is advertised until a frame is published.
+        std::vector<SharedTexture> slots;
+        if (!createSlots(width, height, format, slots)) return;
+
+        if (!slots.empty())
+        {
+            _texture = slots[0];
+            _width = width;
+            _height = height;
+            _sharedFormat = format;
+
+            // The ring is set up again (new epoch) with the new handles.
+            // The copies into the previous slots are left to the GPU.
+            _slots = std::move(slots);
+            _pending.clear();
+            _queries.clear();
+            publishRing();
+
+            auto res = _system->spout.UpdateSender
+              (_name.c_str(), _width, _height, _texture.handle, format);
+
+            if (!res) LogError("UpdateSender", _name, 0);
+            return;
+        }
+
+        // Look for a pooled texture.
+        SharedTexture texture = {};
+        for (auto it = _pool.begin(); it != _pool.end(); ++it)
+        {
+            D3D11_TEXTURE2D_DESC desc;
+            it->d3d11->GetDesc(&desc);
+            if (desc.Width == static_cast<UINT>(width) &&
+                desc.Height == static_cast<UINT>(height) &&
+                desc.Format == format)
+            {
+                texture = *it;
+                break;
+            }
+        }
+
+        if (!texture) texture = createTexture(width, height, format);
+        if (!texture) return;
+
+        // Keep the current texture for reuse.
+        _pool.erase(std::remove_if(_pool.begin(), _pool.end(),
+          [&](const SharedTexture& t) { return t.d3d11 == texture.d3d11; }),
+          _pool.end());
+        _pool.insert(_pool.begin(), _texture);
+        if (_pool.size() > PoolSize) _pool.pop_back();
+
+        _texture = texture;
+        _width = width;
+        _height = height;
+        _sharedFormat = format;
+
+        auto res = _system->spout.UpdateSender
+          (_name.c_str(), _width, _height, _texture.handle, format);
+
+        if (!res) LogError("UpdateSender", _name, 0);
+    }
+
+    // Ring slot textures (none when single buffered)
+    bool createSlots(int width, int height, DXGI_FORMAT format,
+                     std::vector<SharedTexture>& slots)
+    {
+        if (_bufferCount < 2) return true;
+        for (auto i = 0; i < _bufferCount; i++)
+        {
+            auto texture = createTexture(width, height, format);
+            if (!texture) return false;
+            slots.push_back(texture);
+        }
+        return true;
+    }
+
+    // Ring map setup with the handles of the slots
+    // It's written once per set of slots. Without the map, the sender falls
+    // back to single buffering. Single buffered senders have no ring.
+    void publishRing()
+    {
+        if (_slots.empty()) return;
+
+        if (!_ring.IsValid())
+        {
+            auto name = _name + "_ring";
+            if (_ringMap.Create(name.c_str(), sizeof(SpoutRingInfo))
+                  == SPOUT_CREATE_FAILED)
+            {
+                LogError("Create (ring map)", _name, 0);
+                _slots.clear();
+                return;
+            }
+            _ring.Attach(_ringMap.Buffer());
+        }
+
+        uint32_t handles[SpoutRingMaxSlots];
+        for (auto i = 0; i < _bufferCount; i++)
+            handles[i] = static_cast<uint32_t>(HandleToLong(_slots[i].handle));
+        _ring.Initialize(_bufferCount, handles);
+    }
+
+    // Ring slot to copy the frame into (-1 if there is none)
+    // The frame is skipped if receivers hold or the GPU is still writing all
+    // the other slots.
+    int beginWrite()
+    {
+        if (_failed || !_texture || _slots.empty()) return -1;
+        publishCompleted();
+        uint32_t busy = 0;
+        for (auto& write : _pending) busy |= 1u << write.slot;
+        return _ring.BeginWrite(busy);
+    }
+
+    // Track a recorded copy into a slot (fence : native D3D12 submission)
+    void endWrite(int slot, uint64_t fence)
+    {
+        if (fence == 0) endQuery(slot);
+        _pending.push_back({slot, fence});
+        publishCompleted();
+    }
+
+    void endQuery(int slot)
+    {
+        _queries.resize(_slots.size());
+        auto& query = _queries[slot];
+
+        if (!query)
+        {
+            D3D11_QUERY_DESC desc = {};
+            desc.Query = D3D11_QUERY_EVENT;
+            auto hres = _system->getD3D11Device()->CreateQuery(&desc, &query);
+            if (FAILED(hres))
+            {
+                LogError("CreateQuery", _name, hres);
+                return;
+            }
+        }
+
+        _system->getD3D11Context()->End(query.Get());
+    }
+
+    // Publish the latest slot whose copy is done. Older ones are skipped.
+    // Checked without waiting (or flushing) on every update and flush event.
+    void publishCompleted()
+    {
+        auto slot = -1;
+        while (!_pending.empty() && isComplete(_pending.front()))
+        {
+            slot = _pending.front().slot;
+            _pending.erase(_pending.begin());
+        }
+        if (slot < 0) return;
+
+        _ring.EndWrite(slot);
+        _texture = _slots[slot];
+
+        auto res = _system->spout.UpdateSender
+          (_name.c_str(), _width, _height, _texture.handle, _sharedFormat);
+
+        if (!res) LogError("UpdateSender", _name, 0);
+    }
+
+    bool isComplete(const PendingWrite& write) const
+    {
+        if (write.fence > 0)
+            return _system->getD3D12Interface()->GetFrameFence()
+                     ->GetCompletedValue() >= write.fence;
+
+        // No query (creation failure) : Published right away as before.
+        if (static_cast<size_t>(write.slot) >= _queries.size() ||
+            !_queries[write.slot]) return true;
+
+        return _system->getD3D11Context()->GetData
+          (_queries[write.slot].Get(), nullptr, 0,
+           D3D11_ASYNC_GETDATA_DONOTFLUSH) == S_OK;
+    }
+
+    SharedTexture createTexture(int width, int height, DXGI_FORMAT format)
     {
         // Make a Spout-compatible texture description.
         D3D11_TEXTURE2D_DESC desc = {};
-        desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
-        desc.Width = _width;
-        desc.Height = _height;
+        desc.Format = format;
+        desc.Width = width;
+        desc.Height = height;
         desc.MipLevels = 1;
         desc.ArraySize = 1;
         desc.SampleDesc.Count = 1;
@@ -65,59 +447,102 @@ private:
         desc.MiscFlags = D3D11_RESOURCE_MISC_SHARED;
 
         // Create a shared texture.
+        SharedTexture texture = {};
         auto hres = _system->getD3D11Device()
-          ->CreateTexture2D(&desc, nullptr, &_texture);
+          ->CreateTexture2D(&desc, nullptr, &texture.d3d11);
 
         if (FAILED(hres))
         {
             LogError("CereateTexture2D", _name, hres);
-            return;
+            return {};
         }
 
         // Retrieve the texture handle.
-        HANDLE handle;
         WRL::ComPtr<IDXGIResource> resource;
-        _texture.As(&resource);
-        resource->GetSharedHandle(&handle);
+        texture.d3d11.As(&resource);
+        resource->GetSharedHandle(&texture.handle);
 
-        // Create a Spout sender object for the shared texture.
-        auto res = _system->spout
-          .CreateSender(_name.c_str(), _width, _height, handle, desc.Format);
+        // DX12: Open the texture on the D3D12 device as receivers do.
+        // The D3D11On12 copy is used as a fallback if this fails.
+        if (_system->isD3D12)
+        {
+            hres = _system->getD3D12Device()->OpenSharedHandle
+              (texture.handle, IID_PPV_ARGS(&texture.d3d12));
+            if (FAILED(hres)) LogError("OpenSharedHandle (sender)", _name, hres);
+        }
 
-        if (!res) LogError("CreateSender", _name, 0);
+        return texture;
     }
 
-    void updateTexture(ID3D11Resource* source)
+    void updateTexture(const SharedTexture& target, ID3D11Resource* source)
     {
         // Texture copy
-        _system->getD3D11Context()->CopyResource(_texture.Get(), source);
+        _system->getD3D11Context()->CopyResource(target.d3d11.Get(), source);
     }
 
-    void updateTexture(ID3D12Resource* source)
+    // Returns false if the copy couldn't be recorded.
+    bool updateTexture(const SharedTexture& target, ID3D12Resource* source,
+                       const D3D12_RESOURCE_DESC& desc)
     {
+        // Native path: The copy is recorded on the D3D12 copy queue and
+        // submitted on Unity's queue at the end of the update.
+        if (target.d3d12)
+        {
+            if (!_copyQueue) _copyQueue = std::make_unique<SenderCopyQueue>();
+            _copyQueue->copy(target.d3d12.Get(), source);
+            return true;
+        }
+
+        // Fallback: D3D11On12 copy
         auto d3d11on12 = _system->getD3D11On12Device();
 
         // Wrapping: D3D12 -> D3D11
-        D3D11_RESOURCE_FLAGS flags = {};
-        WRL::ComPtr<ID3D11Resource> wrap;
-        auto hres = d3d11on12->CreateWrappedResource
-          (source, &flags,
-           D3D12_RESOURCE_STATE_COPY_SOURCE,
-           D3D12_RESOURCE_STATE_PRESENT,
-           IID_PPV_ARGS(&wrap));
-
-        if (FAILED(hres))
+        if (_wrapSource.Get() != source || _wrapDevice != d3d11on12 ||
+            !isSameDesc(_wrapDesc, desc))
         {
-            LogError("CereateWrappedResource", _name, hres);
-            return;
+            _wrap = nullptr;
+            _wrapSource = nullptr;
+
+            D3D11_RESOURCE_FLAGS flags = {};
+            auto hres = d3d11on12->CreateWrappedResource
+              (source, &flags,
+               D3D12_RESOURCE_STATE_COPY_SOURCE,
+               D3D12_RESOURCE_STATE_PRESENT,
+               IID_PPV_ARGS(&_wrap));
+
+            _system->senderStats.wrapCreations++;
+
+            if (FAILED(hres))
+            {
+                LogError("CereateWrappedResource", _name, hres);
+                return false;
+            }
+
+            _wrapSource = source;
+            _wrapDevice = d3d11on12;
+            _wrapDesc = desc;
         }
 
         // Texture copy
+        // It's submitted with the coalesced flush (see System::flush), so
+        // it reaches receivers one frame late.
         auto ctx = _system->getD3D11Context();
-        d3d11on12->AcquireWrappedResources(wrap.GetAddressOf(), 1);
-        ctx->CopyResource(_texture.Get(), wrap.Get());
-        d3d11on12->ReleaseWrappedResources(wrap.GetAddressOf(), 1);
-        ctx->Flush();
+        d3d11on12->AcquireWrappedResources(_wrap.GetAddressOf(), 1);
+        ctx->CopyResource(target.d3d11.Get(), _wrap.Get());
+        d3d11on12->ReleaseWrappedResources(_wrap.GetAddressOf(), 1);
+        _system->requestFlush();
+        return true;
+    }
+
+    static bool isSameDesc(const D3D12_RESOURCE_DESC& a,
+                           const D3D12_RESOURCE_DESC& b)
+    {
+        return a.Dimension == b.Dimension &&
+               a.Width == b.Width && a.Height == b.Height &&
+               a.DepthOrArraySize == b.DepthOrArraySize &&
+               a.MipLevels == b.MipLevels && a.Format == b.Format &&
+               a.SampleDesc.Count == b.SampleDesc.Count &&
+               a.Flags == b.Flags;
     }
 };
 
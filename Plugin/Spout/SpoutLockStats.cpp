@@ -0,0 +1,141 @@
+/*
+
+	SpoutLockStats.cpp
+
+	Lock-wait counters for SpoutSharedMemory
+
+*/
+
+#include "SpoutLockStats.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string.h>
+
+std::atomic<bool> SpoutLockStats::s_enabled{false};
+
+namespace {
+
+// Process-wide table of counters by map name.
+// std::map keeps the entries in place so that the pointers held by
+// SpoutSharedMemory objects stay valid until they are released.
+std::mutex& TableLock()
+{
+	static std::mutex lock;
+	return lock;
+}
+
+std::map<std::string, SpoutLockStats>& Table()
+{
+	static std::map<std::string, SpoutLockStats> table;
+	return table;
+}
+
+} // anonymous namespace
+
+void SpoutLockStats::Enable(bool enable)
+{
+	s_enabled.store(enable, std::memory_order_relaxed);
+}
+
+SpoutLockStats* SpoutLockStats::Acquire(const char* name)
+{
+	if (!name) return nullptr;
+	std::lock_guard<std::mutex> guard(TableLock());
+	auto entry = Table().try_emplace(name).first;
+	entry->second.m_name = &entry->first;
+	entry->second.m_references++;
+	return &entry->second;
+}
+
+void SpoutLockStats::Release(SpoutLockStats* stats)
+{
+	if (!stats) return;
+	std::lock_guard<std::mutex> guard(TableLock());
+	if (--stats->m_references == 0 && !stats->HasRecords())
+		Table().erase(*stats->m_name);
+}
+
+int SpoutLockStats::Snapshot(SpoutLockStatsData* data, int capacity)
+{
+	std::lock_guard<std::mutex> guard(TableLock());
+
+	int i = 0;
+	for (auto& entry : Table()) {
+		if (i < capacity && data) {
+			SpoutLockStatsData& out = data[i];
+			const SpoutLockStats& stats = entry.second;
+			strncpy(out.name, entry.first.c_str(), SpoutLockStatsNameLen - 1);
+			out.name[SpoutLockStatsNameLen - 1] = 0;
+			out.acquisitions = stats.m_acquisitions.load(std::memory_order_relaxed);
+			out.reentrant = stats.m_reentrant.load(std::memory_order_relaxed);
+			out.timeouts = stats.m_timeouts.load(std::memory_order_relaxed);
+			for (int b = 0; b < SpoutLockStatsBuckets; b++)
+				out.waitHistogram[b] = stats.m_waitHistogram[b].load(std::memory_order_relaxed);
+		}
+		i++;
+	}
+
+	return i;
+}
+
+void SpoutLockStats::Reset()
+{
+	std::lock_guard<std::mutex> guard(TableLock());
+
+	for (auto entry = Table().begin(); entry != Table().end(); ) {
+		if (entry->second.m_references == 0) {
+			entry = Table().erase(entry);
+			continue;
+		}
+		SpoutLockStats& stats = entry->second;
+		stats.m_acquisitions = 0;
+		stats.m_reentrant = 0;
+		stats.m_timeouts = 0;
+		for (auto& bucket : stats.m_waitHistogram) bucket = 0;
+		entry++;
+	}
+}
+
+uint64_t SpoutLockStats::Microseconds()
+{
+	using namespace std::chrono;
+	return (uint64_t)duration_cast<microseconds>
+		(steady_clock::now().time_since_epoch()).count();
+}
+
+void SpoutLockStats::RecordAcquisition(uint64_t waitMicroseconds)
+{
+	m_acquisitions.fetch_add(1, std::memory_order_relaxed);
+	RecordWait(waitMicroseconds);
+}
+
+void SpoutLockStats::RecordReentrant()
+{
+	m_reentrant.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SpoutLockStats::RecordTimeout(uint64_t waitMicroseconds)
+{
+	m_timeouts.fetch_add(1, std::memory_order_relaxed);
+	RecordWait(waitMicroseconds);
+}
+
+void SpoutLockStats::RecordWait(uint64_t waitMicroseconds)
+{
+	// Bucket index : number of significant bits of the wait time
+	int bucket = 0;
+	while (waitMicroseconds && bucket < SpoutLockStatsBuckets - 1) {
+		waitMicroseconds >>= 1;
+		bucket++;
+	}
+	m_waitHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+bool SpoutLockStats::HasRecords() const
+{
+	return m_acquisitions.load(std::memory_order_relaxed) != 0
+		|| m_reentrant.load(std::memory_order_relaxed) != 0
+		|| m_timeouts.load(std::memory_order_relaxed) != 0;
+}
@@ -0,0 +1,86 @@
+/*
+
+	SpoutLockStats.h
+
+	Lock-wait counters for SpoutSharedMemory
+
+	Counters are aggregated per map name in a process-wide table so that
+	waits on "SpoutSenderNames", "ActiveSenderName" and each sender map
+	can be told apart. Recording is off by default and costs a single
+	flag test per Lock() until it is enabled.
+
+*/
+#pragma once
+
+#ifndef __SpoutLockStats__
+#define __SpoutLockStats__
+
+#include <atomic>
+#include <string>
+#include <stdint.h>
+
+// Number of wait-time histogram buckets
+// Bucket 0 : below 1 usec, bucket n : [2^(n-1), 2^n) usec, the last one is open ended
+#define SpoutLockStatsBuckets 20
+
+// Maximum map name length in a snapshot, matching SpoutMaxSenderNameLen
+#define SpoutLockStatsNameLen 256
+
+// Snapshot of the counters of a map name
+struct SpoutLockStatsData {
+	char name[SpoutLockStatsNameLen];
+	uint64_t acquisitions; // Successful non re-entrant locks
+	uint64_t reentrant; // Re-entrant locks by an object already holding the map
+	uint64_t timeouts; // Locks that failed to acquire the mutex
+	uint64_t waitHistogram[SpoutLockStatsBuckets]; // Mutex wait time of all non re-entrant locks
+};
+
+class SpoutLockStats {
+
+public:
+
+	// Turn recording on or off for all maps in the process
+	static void Enable(bool enable);
+
+	// Check if recording is on
+	static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+	// Counters for a map name, created on first use.
+	// Each Acquire is paired with a Release when the map is closed.
+	// An entry is freed with its last reference unless it has recorded
+	// something, in which case it is kept for Snapshot until Reset.
+	static SpoutLockStats* Acquire(const char* name);
+	static void Release(SpoutLockStats* stats);
+
+	// Copy up to "capacity" entries and return the total number of entries
+	static int Snapshot(SpoutLockStatsData* data, int capacity);
+
+	// Clear all counters and free the entries of closed maps
+	static void Reset();
+
+	// Current time for wait measurement
+	static uint64_t Microseconds();
+
+	// Recording functions called from SpoutSharedMemory::Lock
+	void RecordAcquisition(uint64_t waitMicroseconds);
+	void RecordReentrant();
+	void RecordTimeout(uint64_t waitMicroseconds);
+
+private:
+
+	static std::atomic<bool> s_enabled;
+
+	const std::string* m_name = nullptr; // Key of the table entry
+	int m_references = 0; // Open maps using the entry, under the table lock
+
+	std::atomic<uint64_t> m_acquisitions{0};
+	std::atomic<uint64_t> m_reentrant{0};
+	std::atomic<uint64_t> m_timeouts{0};
+	std::atomic<uint64_t> m_waitHistogram[SpoutLockStatsBuckets] = {};
+
+	void RecordWait(uint64_t waitMicroseconds);
+	bool HasRecords() const;
+
+};
+
+#endif
@@ -0,0 +1,200 @@
+/*
+
+	SpoutPosix.h
+
+	Win32 types and functions used by the sender registry
+
+	SpoutSenderNames, SpoutSharedMemory and SpoutUtils are written against
+	the Win32 API. For other platforms this header maps the small subset
+	they use to POSIX and compiler builtins, so that the registry can be
+	built and tested with the POSIX shared memory backend
+	(SpoutSharedMemoryPosix.cpp). It is not included on Windows.
+
+	Only what the registry needs is here : plain types, the secure CRT
+	string functions, 32 bit handle conversion, the interlocked functions
+	on 32 bit values and a few timing and process functions.
+
+*/
+#pragma once
+
+#ifndef __SpoutPosix__
+#define __SpoutPosix__
+
+#ifndef _WIN32
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+//
+// Types
+//
+
+// unsigned __int32 is used for the shared structures
+#define __int32 int
+
+typedef uint32_t DWORD;
+typedef int32_t LONG; // 32 bit as on Windows, unlike long
+typedef unsigned int UINT;
+typedef unsigned char BYTE;
+typedef uint64_t ULONGLONG;
+typedef void* HANDLE;
+typedef void* HKEY;
+typedef void* HWND;
+typedef const char* LPCSTR;
+typedef size_t rsize_t;
+
+#define MAX_PATH 260
+
+#define HKEY_CURRENT_USER ((HKEY)(uintptr_t)0x80000001)
+
+#define LOWORD(l) ((unsigned short)(((uintptr_t)(l)) & 0xffff))
+
+//
+// Secure CRT string functions
+// Truncate instead of invoking the invalid parameter handler.
+//
+
+inline int strcpy_s(char* dest, rsize_t size, const char* src)
+{
+	if (!dest || size == 0) return 1;
+	size_t len = strnlen(src, size - 1);
+	memcpy(dest, src, len);
+	dest[len] = 0;
+	return 0;
+}
+
+template <size_t size>
+inline int strcpy_s(char (&dest)[size], const char* src)
+{
+	return strcpy_s(dest, size, src);
+}
+
+inline int strncpy_s(char* dest, rsize_t size, const char* src, rsize_t count)
+{
+	if (!dest || size == 0) return 1;
+	size_t len = strnlen(src, count < size - 1 ? count : size - 1);
+	memcpy(dest, src, len);
+	dest[len] = 0;
+	return 0;
+}
+
+template <size_t size>
+inline int strncpy_s(char (&dest)[size], const char* src, rsize_t count)
+{
+	return strncpy_s(dest, size, src, count);
+}
+
+inline int vsprintf_s(char* buffer, size_t size, const char* format, va_list args)
+{
+	return vsnprintf(buffer, size, format, args);
+}
+
+inline int sprintf_s(char* buffer, size_t size, const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	int res = vsnprintf(buffer, size, format, args);
+	va_end(args);
+	return res;
+}
+
+//
+// 32 bit handle conversion
+//
+
+inline HANDLE LongToHandle(long h)
+{
+	return (HANDLE)(intptr_t)h;
+}
+
+inline long HandleToLong(const void* h)
+{
+	return (long)(intptr_t)h;
+}
+
+inline unsigned int PtrToUint(const void* p)
+{
+	return (unsigned int)(uintptr_t)p;
+}
+
+//
+// Interlocked functions and barriers (full barriers as on Windows)
+//
+
+inline LONG InterlockedExchange(volatile LONG* target, LONG value)
+{
+	return __atomic_exchange_n(target, value, __ATOMIC_SEQ_CST);
+}
+
+inline LONG InterlockedCompareExchange(volatile LONG* target, LONG exchange, LONG comparand)
+{
+	__atomic_compare_exchange_n(target, &comparand, exchange, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return comparand;
+}
+
+inline LONG InterlockedIncrement(volatile LONG* target)
+{
+	return __atomic_add_fetch(target, 1, __ATOMIC_SEQ_CST);
+}
+
+inline LONG InterlockedDecrement(volatile LONG* target)
+{
+	return __atomic_sub_fetch(target, 1, __ATOMIC_SEQ_CST);
+}
+
+inline void MemoryBarrier()
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
+
+inline void YieldProcessor()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#else
+	sched_yield();
+#endif
+}
+
+// Copy of a number of 32 bit words
+inline void __movsd(void* dest, const void* src, size_t count)
+{
+	memcpy(dest, src, count * 4);
+}
+
+//
+// Time and process
+//
+
+inline ULONGLONG GetTickCount64()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ULONGLONG)ts.tv_sec * 1000 + (ULONGLONG)ts.tv_nsec / 1000000;
+}
+
+inline DWORD GetCurrentProcessId()
+{
+	return (DWORD)getpid();
+}
+
+// Path of the executable (hModule must be NULL)
+inline DWORD GetModuleFileNameA(void* hModule, char* filename, DWORD size)
+{
+	(void)hModule;
+	if (size == 0) return 0;
+	ssize_t len = readlink("/proc/self/exe", filename, size - 1);
+	if (len < 0) len = 0;
+	filename[len] = 0;
+	return (DWORD)len;
+}
+
+#endif // _WIN32
+
+#endif
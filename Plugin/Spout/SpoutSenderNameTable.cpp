@@ -0,0 +1,173 @@
+/*
+
+	SpoutSenderNameTable.cpp
+
+	Flat sorted table of sender names
+
+*/
+
+#include "SpoutSenderNameTable.h"
+#include <algorithm>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace {
+
+#if defined(__SSE2__) || defined(_M_X64)
+
+int CountTrailingZeros(unsigned int mask)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (int)index;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+// Length of the name in a slot, testing 16 bytes at a time for the null.
+// The slot size is a multiple of 16, so the loads stay within the slot.
+size_t SlotLength(const char* slot, size_t maxLength)
+{
+	const __m128i zero = _mm_setzero_si128();
+	size_t i = 0;
+	for (; i + 16 <= maxLength; i += 16) {
+		__m128i chunk = _mm_loadu_si128((const __m128i*)(slot + i));
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(chunk, zero));
+		if (mask) return i + CountTrailingZeros((unsigned int)mask);
+	}
+	for (; i < maxLength; i++)
+		if (!slot[i]) return i;
+	return maxLength;
+}
+
+#else
+
+size_t SlotLength(const char* slot, size_t maxLength)
+{
+	const void* end = memchr(slot, 0, maxLength);
+	return end ? (size_t)((const char*)end - slot) : maxLength;
+}
+
+#endif
+
+} // anonymous namespace
+
+bool SpoutSenderNameTable::Parse(const char* buffer, int maxSenders, int slotSize)
+{
+	Clear();
+
+	// Keeps the capacity from the previous parse
+	m_arena.reserve((size_t)maxSenders * slotSize);
+	m_entries.reserve((size_t)maxSenders);
+
+	bool full = ReadSlots(buffer, maxSenders, slotSize);
+	Sort();
+	return full;
+}
+
+bool SpoutSenderNameTable::ParseSegment(const char* buffer, int maxSenders, int slotSize)
+{
+	bool full = ReadSlots(buffer, maxSenders, slotSize);
+	Sort();
+	return full;
+}
+
+int SpoutSenderNameTable::Write(char* buffer, int maxSenders, int slotSize, int first) const
+{
+	char* slot = buffer;
+	int i = 0;
+
+	for (int index = first; index < Size(); index++) {
+		if (i >= maxSenders) break; // do not exceed the size of the map
+		const Entry& e = m_entries[index];
+		memcpy(slot, m_arena.data() + e.offset, e.length);
+		slot[e.length] = 0;
+		slot += slotSize;
+		i++;
+	}
+
+	// Terminate the list if the map is not full
+	if (i < maxSenders) *slot = 0;
+
+	return i;
+}
+
+bool SpoutSenderNameTable::Insert(const char* name)
+{
+	std::string_view view(name);
+	auto pos = LowerBound(view);
+	if (pos != m_entries.end() && View(*pos) == view) return false;
+	size_t index = pos - m_entries.begin();
+	Entry e = Append(view);
+	m_entries.insert(m_entries.begin() + index, e);
+	return true;
+}
+
+bool SpoutSenderNameTable::Erase(const char* name)
+{
+	std::string_view view(name);
+	auto pos = LowerBound(view);
+	if (pos == m_entries.end() || View(*pos) != view) return false;
+	// The characters stay in the arena until the next Parse or Clear
+	m_entries.erase(pos);
+	return true;
+}
+
+bool SpoutSenderNameTable::Contains(const char* name) const
+{
+	std::string_view view(name);
+	auto pos = LowerBound(view);
+	return pos != m_entries.end() && View(*pos) == view;
+}
+
+void SpoutSenderNameTable::Clear()
+{
+	m_arena.clear();
+	m_entries.clear();
+}
+
+bool SpoutSenderNameTable::ReadSlots(const char* buffer, int maxSenders, int slotSize)
+{
+	// The list ends at the first empty slot or at the end of the map.
+	// A name has to be null terminated within its slot.
+	const char* slot = buffer;
+	for (int i = 0; i < maxSenders; i++, slot += slotSize) {
+		size_t length = SlotLength(slot, (size_t)slotSize);
+		if (length == 0) return false;
+		if (length == (size_t)slotSize) length = (size_t)slotSize - 1;
+		m_entries.push_back(Append(std::string_view(slot, length)));
+	}
+	return true;
+}
+
+void SpoutSenderNameTable::Sort()
+{
+	// Same ordering and uniqueness as std::set<std::string>
+	std::sort(m_entries.begin(), m_entries.end(),
+		[this](const Entry& a, const Entry& b) { return View(a) < View(b); });
+	m_entries.erase(std::unique(m_entries.begin(), m_entries.end(),
+		[this](const Entry& a, const Entry& b) { return View(a) == View(b); }),
+		m_entries.end());
+}
+
+std::vector<SpoutSenderNameTable::Entry>::const_iterator
+	SpoutSenderNameTable::LowerBound(std::string_view name) const
+{
+	return std::lower_bound(m_entries.begin(), m_entries.end(), name,
+		[this](const Entry& e, std::string_view n) { return View(e) < n; });
+}
+
+SpoutSenderNameTable::Entry SpoutSenderNameTable::Append(std::string_view name)
+{
+	Entry e = { (uint32_t)m_arena.size(), (uint32_t)name.size() };
+	m_arena.insert(m_arena.end(), name.begin(), name.end());
+	return e;
+}
@@ -0,0 +1,91 @@
+/*
+
+	SpoutSenderNameTable.h
+
+	Flat sorted table of sender names
+
+	Used in place of std::set<std::string> on the frequent paths of
+	spoutSenderNames. The names are copied into a single character arena
+	and indexed by a sorted array of offsets, so that parsing the sender
+	set map again reuses the same storage and a lookup is a binary search.
+	After the first parse of a map of a given size, Parse, Contains,
+	Insert, Erase, Write and iteration don't allocate.
+
+*/
+#pragma once
+
+#ifndef __SpoutSenderNameTable__
+#define __SpoutSenderNameTable__
+
+#include <string_view>
+#include <vector>
+#include <stdint.h>
+
+class SpoutSenderNameTable {
+
+public:
+
+	// Rebuild the table from a sender set map buffer of maxSenders slots.
+	// Returns true if all the slots are used, in which case the list may
+	// continue in an extension segment.
+	bool Parse(const char* buffer, int maxSenders, int slotSize);
+
+	// Add the names of an extension segment of the sender set.
+	// Returns true if all the slots of the segment are used.
+	bool ParseSegment(const char* buffer, int maxSenders, int slotSize);
+
+	// Write the names from index "first" to a sender set map buffer of
+	// maxSenders slots. The list is terminated if it doesn't fill the map.
+	// Returns the number of names written.
+	int Write(char* buffer, int maxSenders, int slotSize, int first = 0) const;
+
+	// Add a name, returns false if it was already there
+	bool Insert(const char* name);
+
+	// Remove a name, returns false if it was not there
+	bool Erase(const char* name);
+
+	// Test for a name
+	bool Contains(const char* name) const;
+
+	void Clear();
+
+	int Size() const { return (int)m_entries.size(); }
+	bool Empty() const { return m_entries.empty(); }
+
+	// Name by index in sorted order, valid until the table is modified
+	std::string_view operator[](int index) const {
+		const Entry& e = m_entries[index];
+		return std::string_view(m_arena.data() + e.offset, e.length);
+	}
+
+private:
+
+	// Names are referenced by offset because the arena may move on Insert
+	struct Entry {
+		uint32_t offset;
+		uint32_t length;
+	};
+
+	std::vector<char> m_arena;
+	std::vector<Entry> m_entries;
+
+	std::string_view View(const Entry& e) const {
+		return std::string_view(m_arena.data() + e.offset, e.length);
+	}
+
+	// Append the names of a buffer, returns true if it is full
+	bool ReadSlots(const char* buffer, int maxSenders, int slotSize);
+
+	// Sort the entries and remove duplicates
+	void Sort();
+
+	// Position of the first entry not less than the name
+	std::vector<Entry>::const_iterator LowerBound(std::string_view name) const;
+
+	// Append a name to the arena and return its entry
+	Entry Append(std::string_view name);
+
+};
+
+#endif
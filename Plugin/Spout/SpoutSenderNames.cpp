@@ -72,6 +72,39 @@
 	27.02.21 - Change SetSenderCPUmode name to SetSenderID
 	09.04.21 - Add GetSender to retrieve class sender.
 			   Remove SenderDebug
+	18.10.26 - getSharedInfo - keep sender info maps open in a cache keyed by name
+			   Add releaseSharedInfo to drop a cached map
+			 - Sequence word in SharedTextureInfo::usage for lock-free info reads
+			 - CheckSender overload with a lock policy for render thread polling
+			 - Sender set generation in "SpoutSenderNamesGeneration" and
+			   a parsed sender set cache to skip redundant rebuilds
+			 - Add CheckSenders to check many senders with one sender set read
+			 - Add SweepOrphans and SetDeferredCleanup to move orphan removal
+			   off the sender check paths
+			 - SetSenderInfo - keep a copy of the published info and only
+			   write the fields when they change. Host path read once.
+			 - Sender set extension segments for more than m_MaxSenders names
+			 - Add GetSenderSnapshot
+			 - Add ValidateSenderSet for registry consistency checks
+			 - CheckSenders - compare the info sequence word with the stamp
+			   of the last check before reading the info
+			 - Sender set cache as a flat SpoutSenderNameTable
+			   Add GetSenderNameTable for enumeration without copies
+			 - Register, release, clean and sweep edit the sender set in a
+			   persistent SpoutSenderNameTable instead of a std::set
+			 - Sender process ID in the description so that cached info maps
+			   of crashed senders are detected, add senderExists
+			 - CreateSender - create the info map before registering the name
+			   so that an orphan sweep can't remove a new sender
+			 - Sender set segments - a header with the number of names,
+			   always merged with the first map. The first map is sized
+			   from the map itself and keeps slots for legacy applications.
+			 - Build on other platforms with SpoutPosix.h (64 bit handle casts
+			   for LP64 as well as _M_X64)
+			 - Info cache keyed by views of the names held by the entries,
+			   so that lookups by name don't allocate
+			 - Add SetSenderRowOrder - bottom-up flag in the partner ID,
+			   returned by CheckSenders
 
 	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 	Copyright (c) 2014-2021, Lynn Jarvis. All rights reserved.
@@ -100,6 +133,10 @@
 */
 #include "SpoutSenderNames.h"
 #include <assert.h>
+#ifndef _WIN32
+#include <errno.h>
+#include <signal.h>
+#endif
 
 //
 // Class: spoutSenderNames
@@ -112,6 +149,18 @@
 spoutSenderNames::spoutSenderNames() {
 
 	m_senders = new std::unordered_map<std::string, SpoutSharedMemory*>();
+	m_infoCache = new std::unordered_map<std::string_view, SharedInfoCacheEntry>();
+	m_senderShadows = new std::unordered_map<std::string, SharedTextureInfo>();
+	m_senderSetSegments = new std::vector<SpoutSharedMemory*>();
+	m_senderSetSlots = 0;
+
+	m_senderSetWork = new SpoutSenderNameTable();
+	m_senderSetCache = new SpoutSenderNameTable();
+	m_senderSetCacheGeneration = 0;
+	m_senderSetCacheTime = 0;
+	m_senderSetCacheValid = false;
+
+	m_bDeferredCleanup = false;
 
 	// 15.09.18 - moved from interop class
 	// 06.06.19 - increase default maximum number of senders from 10 to 256
@@ -131,6 +180,21 @@ spoutSenderNames::~spoutSenderNames() {
 		delete itr->second;
 	}
 	delete m_senders;
+	delete m_senderShadows;
+
+	for (SpoutSharedMemory* segment : *m_senderSetSegments)
+	{
+		delete segment;
+	}
+	delete m_senderSetSegments;
+
+	for (auto itr = m_infoCache->begin(); itr != m_infoCache->end(); itr++)
+	{
+		delete itr->second.map;
+	}
+	delete m_infoCache;
+	delete m_senderSetWork;
+	delete m_senderSetCache;
 	
 }
 
@@ -143,8 +207,14 @@ spoutSenderNames::~spoutSenderNames() {
 //
 bool spoutSenderNames::RegisterSenderName(const char* Sendername) {
 
-	std::pair<std::set<std::string>::iterator, bool> ret;
-	std::set<std::string> SenderNames; // set of names
+	return registerSenderName(Sendername, false);
+
+}
+
+bool spoutSenderNames::registerSenderName(const char* Sendername, bool bTakeOver) {
+
+	bool ret;
+	SpoutSenderNameTable& SenderNames = *m_senderSetWork; // set of names
 
 	// Create the shared memory for the sender name set if it does not exist
 	if(!CreateSenderSet()) return false;
@@ -153,12 +223,12 @@ bool spoutSenderNames::RegisterSenderName(const char* Sendername) {
 	if (!pBuf) return false;
 
 	// Register the sender name in the list of spout senders
-	readSenderSetFromBuffer(pBuf, SenderNames, m_MaxSenders);
+	readSenderSet(pBuf, SenderNames);
 
 	// Check whether the sender registration will exceed the maximum number of senders
 	// If this fails, just skip the registration
-	if ((int)SenderNames.size() == m_MaxSenders) {
-		SpoutLogWarning("spoutSenderNames::RegisterSenderName - Sender exceeds max senders (%d)", m_MaxSenders);
+	if (SenderNames.Size() >= senderSetCapacity()) {
+		SpoutLogWarning("spoutSenderNames::RegisterSenderName - Sender exceeds max senders (%d)", senderSetCapacity());
 		m_senderNames.Unlock();
 		return true;
 	}
@@ -166,17 +236,35 @@ bool spoutSenderNames::RegisterSenderName(const char* Sendername) {
 	//
 	// Add the Sender name to the set of names
 	//
-	ret = SenderNames.insert(Sendername);
-	if(!ret.second) {
-		// See if there are any dangling entries that aren't valid anymore
-		cleanSenderSet();
-		readSenderSetFromBuffer(pBuf, SenderNames, m_MaxSenders);
-		ret = SenderNames.insert(Sendername);
+	ret = SenderNames.Insert(Sendername);
+	if(!ret && bTakeOver) {
+		// CreateSender has found the name free before writing the info
+		// map, which now holds this process. The name stays in the set.
+		ret = true;
+	}
+	else if(!ret) {
+		if (m_bDeferredCleanup) {
+			// Only the colliding name is checked. It can be taken over
+			// if it was left by a sender that has gone (by the process
+			// published in its info map).
+			releaseSharedInfo(Sendername);
+			if (!senderExists(Sendername)) {
+				// The name stays in the set and is taken over
+				ret = true;
+			}
+		}
+		else {
+			// See if there are any dangling entries that aren't valid anymore
+			cleanSenderSet();
+			readSenderSet(pBuf, SenderNames);
+			ret = SenderNames.Insert(Sendername);
+		}
 	}
 
-	if(ret.second) {
+	if(ret) {
 		// write the new map to shared memory
-		writeBufferFromSenderSet(SenderNames, pBuf, m_MaxSenders);
+		writeSenderSet(SenderNames, pBuf);
+		bumpSenderSetGeneration();
 		// Set as the active Sender if it is the first one registered
 		// Thereafter the user can select an active Sender using SpoutPanel or SpoutSenders
 		m_activeSender.Create("ActiveSenderName", SpoutMaxSenderNameLen);
@@ -188,7 +276,7 @@ bool spoutSenderNames::RegisterSenderName(const char* Sendername) {
 
 	m_senderNames.Unlock();
 
-	return ret.second;
+	return ret;
 }
 
 //
@@ -196,7 +284,7 @@ bool spoutSenderNames::RegisterSenderName(const char* Sendername) {
 //
 bool spoutSenderNames::ReleaseSenderName(const char* Sendername) 
 {
-	std::set<std::string> SenderNames;
+	SpoutSenderNameTable& SenderNames = *m_senderSetWork;
 	std::string namestring;
 	char name[SpoutMaxSenderNameLen];
 
@@ -215,10 +303,14 @@ bool spoutSenderNames::ReleaseSenderName(const char* Sendername)
 	if (foundSender != m_senders->end()) {
 		delete foundSender->second;
 		m_senders->erase(namestring);
+		m_senderShadows->erase(namestring);
 	}
 
+	// Drop the cached info map so that the sender map can be closed
+	releaseSharedInfo(Sendername);
+
 	// Read the buffer to a set to iterate through the names
-	readSenderSetFromBuffer(pBuf, SenderNames, m_MaxSenders);
+	readSenderSet(pBuf, SenderNames);
 
 	// Discovered that the project properties had been set to CLI
 	// Properties -> General -> Common Language Runtime Support
@@ -226,18 +318,18 @@ bool spoutSenderNames::ReleaseSenderName(const char* Sendername)
 	// It also disabled intellisense.
 
 	// If the sender exists
-	if(SenderNames.find(Sendername) != SenderNames.end() ) {
-		SenderNames.erase(Sendername);
+	if(SenderNames.Erase(Sendername)) {
 		// Write the sender names back to the buffer
-		writeBufferFromSenderSet(SenderNames, pBuf, m_MaxSenders);
+		writeSenderSet(SenderNames, pBuf);
+		bumpSenderSetGeneration();
 		// Is there a set left ?
-		if(SenderNames.size() > 0) {
+		if(SenderNames.Size() > 0) {
 			// Was it the active sender ?
-			if( (getActiveSenderName(name) && strcmp(name, Sendername) == 0) || SenderNames.size() == 1) { 
+			if( (getActiveSenderName(name) && strcmp(name, Sendername) == 0) || SenderNames.Size() == 1) { 
 				// It was, so choose the first in the list and make it active instead
-				std::set<std::string>::iterator iter = SenderNames.begin();
-				namestring = *iter;
-				strcpy_s(name, namestring.c_str());
+				std::string_view first = SenderNames[0];
+				first.copy(name, SpoutMaxSenderNameLen - 1);
+				name[first.size()] = 0;
 				// Set it as the active sender
 				setActiveSenderName(name);
 			}
@@ -252,22 +344,16 @@ bool spoutSenderNames::ReleaseSenderName(const char* Sendername)
 } // end ReleaseSenderName
 
 // Test to see if the Sender name exists in the sender set
+// 18.10.26 - Look up the cached set, only re-read when the generation has moved
 bool spoutSenderNames::FindSenderName(const char* Sendername)
 {
-	std::string namestring = "";
-	std::set<std::string> SenderNames;
-	std::set<std::string>::iterator iter;
-	
+	SpoutLockPolicy policy = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+
 	if(Sendername[0]) { // was a valid name passed
-		// Get the current list to update the passed list
-		if(GetSenderSet(SenderNames)) {
-			if (SenderNames.size() > 0) {
-				for (iter = SenderNames.begin(); iter != SenderNames.end(); iter++) {
-					namestring = *iter;
-				}
-			}
+		// Get the current list
+		if (updateSenderSetCache(policy) == SPOUT_CHECK_SUCCESS) {
 			// Does the name exist
-			if (SenderNames.find(Sendername) != SenderNames.end()) {
+			if (m_senderSetCache->Contains(Sendername)) {
 				return true;
 			}
 		}
@@ -287,42 +373,58 @@ void spoutSenderNames::cleanSenderSet()
 	    return;
 	}
 
-	std::set<std::string> SenderNames;
-	readSenderSetFromBuffer(pBuf, SenderNames, m_MaxSenders);
+	SpoutSenderNameTable& SenderNames = *m_senderSetWork;
+	readSenderSet(pBuf, SenderNames);
 
 	bool changed = false;
+	char name[SpoutMaxSenderNameLen];
 
-	for (auto itr = SenderNames.begin(); itr != SenderNames.end(); )
+	// Backwards so that erasing doesn't move the names still to check
+	for (int i = SenderNames.Size() - 1; i >= 0; i--)
 	{
+		std::string_view view = SenderNames[i];
+		view.copy(name, SpoutMaxSenderNameLen - 1);
+		name[view.size()] = 0;
 		// It's one of ours, so thats fine
-		if (m_senders->find(*itr) != m_senders->end())
-		{
-			itr++;
+		if (m_senders->find(name) != m_senders->end())
 			continue;
-		}
-		SpoutSharedMemory mem;
 		// This isn't found, we clean it up
-		if (!mem.Open((*itr).c_str()))
+		if (!senderExists(name))
 		{
 			changed = true;
-			SenderNames.erase(itr++);
+			SenderNames.Erase(name);
 		}
-		else
-		{
-			++itr;
-		}
-		
 	}
 
 	if (changed)
 	{
-		writeBufferFromSenderSet(SenderNames, pBuf, m_MaxSenders);
+		writeSenderSet(SenderNames, pBuf);
+		bumpSenderSetGeneration();
+		// Make the first sender active if the active one was released
+		if (SenderNames.Size() > 0 &&
+			(!getActiveSenderName(name) || !SenderNames.Contains(name))) {
+			std::string_view first = SenderNames[0];
+			first.copy(name, SpoutMaxSenderNameLen - 1);
+			name[first.size()] = 0;
+			setActiveSenderName(name);
+		}
 	}
 
 	m_senderNames.Unlock();
 	
 }
 
+// Return the sender name table, re-read only if the set has changed
+const SpoutSenderNameTable* spoutSenderNames::GetSenderNameTable()
+{
+	SpoutLockPolicy policy = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+
+	if (updateSenderSetCache(policy) != SPOUT_CHECK_SUCCESS)
+		return NULL;
+
+	return m_senderSetCache;
+}
+
 // Return the set of Sender names in shared memory.
 bool spoutSenderNames::GetSenderNames(std::set<std::string> *Sendernames)
 {
@@ -336,56 +438,24 @@ bool spoutSenderNames::GetSenderNames(std::set<std::string> *Sendernames)
 
 int spoutSenderNames::GetSenderCount() {
 
-	std::set<std::string> SenderSet;
-	std::set<std::string>::iterator iter;
-	std::string namestring;
-	char name[SpoutMaxSenderNameLen];
-	SharedTextureInfo info;
-
-	// Create the shared memory for the sender name set if it does not exist
-	if(!CreateSenderSet()) {
-		return 0;
-	}
-
-	// Doing multiple operations on the sender list, keep it locked
-	if (!m_senderNames.Lock())
-	{
-		return 0;
+	// 18.10.26 - Orphans are removed by SweepOrphans
+	if (m_bDeferredCleanup) {
+		const SpoutSenderNameTable* table = GetSenderNameTable();
+		return table ? table->Size() : 0;
 	}
 
-	// get the name list in shared memory into a local list
-	GetSenderNames(&SenderSet);
-
-	// Now we have a local set of names
 	// 27.12.13 - noted that if a Processing sketch is stopped by closing the window
 	// all is OK and either the "stop" or "dispose" overrides work, but if STOP is used, 
 	// or the sketch is closed, neither the exit or dispose functions are called and
 	// the sketch does not release the sender.
-	// So here we run through again and check whether the sender exists and if it does not
-	// release the sender from the local sender list
-	if(SenderSet.size() > 0) {
-		for(iter = SenderSet.begin(); iter != SenderSet.end(); iter++) {
-			namestring = *iter; // the Sender name string
-			strcpy_s(name, namestring.c_str());
-			// we have the name already, so look for it's info
-			if(!getSharedInfo(name, &info)) {
-				// Sender does not exist any more
-				ReleaseSenderName(name); // release from the shared memory list
-			}
-		}
-	}
-
-	// Get the new set back
-	if(GetSenderNames(&SenderSet)) {
-		m_senderNames.Unlock();
-		return((int)SenderSet.size());
-	}
+	// So here we check whether the senders exist and release those that don't
+	cleanSenderSet();
 
-	m_senderNames.Unlock();
-
-	return 0;
+	const SpoutSenderNameTable* table = GetSenderNameTable();
+	return table ? table->Size() : 0;
 }
 
+
 // Get sender info given a sender index and knowing the sender count
 // index                        - in
 // sendername                   - out
@@ -393,34 +463,22 @@ int spoutSenderNames::GetSenderCount() {
 // width, height, dxShareHandle - out
 bool spoutSenderNames::GetSenderNameInfo(int index, char* sendername, int sendernameMaxSize, unsigned int &width, unsigned int &height, HANDLE &dxShareHandle)
 {
-	char name[SpoutMaxSenderNameLen];
-	std::set<std::string> SenderNameSet;
-	std::set<std::string>::iterator iter;
-	std::string namestring;
-	int i;
 	DWORD format;
 
-	if(GetSenderNames(&SenderNameSet)) {
-		if(SenderNameSet.size() < (unsigned int)index)
-			return false;
+	const SpoutSenderNameTable* SenderNameSet = GetSenderNameTable();
+	if (!SenderNameSet || index < 0 || index >= SenderNameSet->Size())
+		return false;
 
-		i = 0;
-		for(iter = SenderNameSet.begin(); iter != SenderNameSet.end(); iter++) {
-			namestring = *iter; // the name string
-			strcpy_s(name, SpoutMaxSenderNameLen, namestring.c_str()); // the 256 byte name char array
-			if(i == index) {
-				strcpy_s(sendername, (rsize_t)sendernameMaxSize, name); // the passed name char array
-				break;
-			}
-			i++;
-		}
-		
-		// Does the retrieved sender exist or has it crashed?
-		// Find out by getting the sender info and returning it
-		if(GetSenderInfo(sendername, width, height, dxShareHandle, format))
-			return true;
+	std::string_view name = (*SenderNameSet)[index];
+	if (sendernameMaxSize <= 0)
+		return false;
+	size_t length = name.copy(sendername, (size_t)sendernameMaxSize - 1);
+	sendername[length] = 0;
 
-	}
+	// Does the retrieved sender exist or has it crashed?
+	// Find out by getting the sender info and returning it
+	if(GetSenderInfo(sendername, width, height, dxShareHandle, format))
+		return true;
 
 	return false;
 
@@ -429,6 +487,66 @@ bool spoutSenderNames::GetSenderNameInfo(int index, char* sendername, int sender
 // Set the maximum number of senders contained in the sender map
 // Subsequently a new sender map will be created large enough for the number of senders
 // but if a map is already open, it's size will not be changed
+//
+// 18.10.26 - Info of all the senders in one call
+// The sender set stays locked while the info maps are read, so the
+// entries match a single state of the set. Senders that no longer
+// exist are left out. The info maps are kept open in the info cache,
+// so repeated calls don't open them again.
+//
+int spoutSenderNames::GetSenderSnapshot(SpoutSenderSnapshot* entries, int capacity, char* names, int namesSize, const SpoutLockPolicy& policy)
+{
+	if (!CreateSenderSet())
+		return 0;
+
+	if (!m_senderNames.Lock(policy))
+		return 0;
+
+	// Takes the lock again re-entrantly if the set has to be parsed
+	if (updateSenderSetCache(policy) != SPOUT_CHECK_SUCCESS) {
+		m_senderNames.Unlock();
+		return 0;
+	}
+
+	int count = 0;
+	int namesUsed = 0;
+	char name[SpoutMaxSenderNameLen];
+	SharedTextureInfo info;
+
+	for (int i = 0; i < m_senderSetCache->Size(); i++) {
+
+		std::string_view view = (*m_senderSetCache)[i];
+		view.copy(name, view.size());
+		name[view.size()] = 0;
+
+		if (readSharedInfo(name, &info, policy) != SPOUT_CHECK_SUCCESS)
+			continue;
+
+		if (count < capacity) {
+			SpoutSenderSnapshot& entry = entries[count];
+			entry.width       = (unsigned int)info.width;
+			entry.height      = (unsigned int)info.height;
+			entry.format      = (DWORD)info.format;
+			entry.shareHandle = info.shareHandle;
+			entry.stamp       = (info.usage & 0xFFFF0000) == SpoutInfoSeqMagic ? (info.usage & 0xFFFF) : 0;
+			entry.nameOffset  = namesUsed;
+			entry.nameLength  = 0;
+			if (names && namesUsed + (int)view.size() + 1 <= namesSize) {
+				memcpy(names + namesUsed, name, view.size() + 1);
+				entry.nameLength = (int)view.size();
+				namesUsed += (int)view.size() + 1;
+			}
+		}
+
+		count++;
+	}
+
+	m_senderNames.Unlock();
+
+	return count;
+
+} // end GetSenderSnapshot
+
 void spoutSenderNames::SetMaxSenders(int maxSenders)
 {
 	SpoutLogNotice("spoutSenderNames::SetMaxSenders - Setting max senders to %d", maxSenders);
@@ -452,7 +570,7 @@ bool spoutSenderNames::GetSenderInfo(const char* sendername, unsigned int &width
 	if(getSharedInfo(sendername, &info)) {
 		width		  = (unsigned int)info.width;
 		height		  = (unsigned int)info.height;
-#ifdef _M_X64
+#if defined(_M_X64) || defined(__LP64__)
 		dxShareHandle = (HANDLE)(LongToHandle((long)info.shareHandle));
 #else
 		dxShareHandle = (HANDLE)info.shareHandle;
@@ -468,6 +586,12 @@ bool spoutSenderNames::GetSenderInfo(const char* sendername, unsigned int &width
 // Set texture info to a sender shared memory map without affecting the 
 // interop class globals used for GL/DX interop texture sharing
 // TODO - use pointer from initial map creation
+//
+// 18.10.26 - The info last written is kept in m_senderShadows.
+// The map is not locked at all if nothing has changed, and only the texture
+// fields are written after the first time. The description and partner ID
+// are left as they are, so a SetSenderID value is kept on a resize.
+//
 bool spoutSenderNames::SetSenderInfo(const char* sendername, unsigned int width, unsigned int height, HANDLE dxShareHandle, DWORD dwFormat) 
 {
 	SharedTextureInfo info;
@@ -483,42 +607,71 @@ bool spoutSenderNames::SetSenderInfo(const char* sendername, unsigned int width,
 
 	auto senderInfoMap = foundSender->second;
 
-	char *pBuf = senderInfoMap->Lock();
-
-	if (!pBuf)
-	{
-		return false;
-	}
-		
 	info.width       = (unsigned __int32)width;
 	info.height      = (unsigned __int32)height;
-#ifdef _M_X64
+#if defined(_M_X64) || defined(__LP64__)
 	info.shareHandle = (unsigned __int32)(HandleToLong(dxShareHandle));
 #else
 	info.shareHandle = (unsigned __int32)dxShareHandle;
 #endif
 	info.format      = (unsigned __int32)dwFormat;
-	
+
+	auto shadow = m_senderShadows->find(nameString);
+
+	// Nothing to do if the published info is the same
+	if (shadow != m_senderShadows->end()
+		&& shadow->second.width == info.width
+		&& shadow->second.height == info.height
+		&& shadow->second.shareHandle == info.shareHandle
+		&& shadow->second.format == info.format) {
+		return true;
+	}
+
+	char *pBuf = senderInfoMap->Lock();
+
+	if (!pBuf)
+	{
+		return false;
+	}
+
+	if (shadow != m_senderShadows->end()) {
+		// Only the texture fields have changed
+		writeSharedInfoFields(pBuf, &info);
+		shadow->second.width       = info.width;
+		shadow->second.height      = info.height;
+		shadow->second.shareHandle = info.shareHandle;
+		shadow->second.format      = info.format;
+		senderInfoMap->Unlock();
+		return true;
+	}
+
 	//
 	// Initialize unused variables
 	//
 
-	// Texture usage
+	// Texture usage : sequence word set by writeSharedInfoBuffer
 	info.usage = 0;
 
 	// Description : Host path
-	char exepath[256];
-	GetModuleFileNameA(NULL, exepath, sizeof(exepath));
+	// The path of the process does not change, so it is read only once
+	static char exepath[256];
+	if (!exepath[0])
+		GetModuleFileNameA(NULL, exepath, sizeof(exepath));
 
 	// Partner ID : Sender CPU sharing mode
 	// Set by SetSenderID
 	// TODO : combine here
+	info.partnerId = 0;
 
 	// Description is defined as wide chars, but the path is stored as byte chars
 	memcpy((void *)info.description, (void *)exepath, 256); // wchar 128
 
+	// Process ID after the path for receivers to detect a crashed sender
+	setSenderProcessId(&info, GetCurrentProcessId());
+
 	// Set data to the memory map
-	__movsd((unsigned long *)pBuf, (unsigned long const *)&info, sizeof(SharedTextureInfo) / 4); // 280 bytes
+	writeSharedInfoBuffer(pBuf, &info);
+	(*m_senderShadows)[nameString] = info;
 
 	senderInfoMap->Unlock();
 	
@@ -568,6 +721,26 @@ bool spoutSenderNames::SetSenderID(const char *sendername, bool bCPU, bool bGLDX
 	return false;
 }
 
+//
+// Set or clear the bottom-up row order flag (SpoutInfoBottomUp) in the
+// partnerID field. The other bits are kept.
+//
+bool spoutSenderNames::SetSenderRowOrder(const char *sendername, bool bBottomUp)
+{
+	SharedTextureInfo info;
+
+	if (getSharedInfo(sendername, &info)) {
+		if (bBottomUp)
+			info.partnerId |= SpoutInfoBottomUp;
+		else
+			info.partnerId &= ~(unsigned __int32)SpoutInfoBottomUp;
+		setSharedInfo(sendername, &info);
+		return true;
+	}
+
+	return false;
+}
+
 // Functions to set or get the active Sender name
 // The "active" Sender is the one of the multiple Senders
 // that is top of the list or is the one selected by the user from this list. 
@@ -581,8 +754,6 @@ bool spoutSenderNames::SetSenderID(const char *sendername, bool bCPU, bool bGLDX
 
 bool spoutSenderNames::SetActiveSender(const char *Sendername)
 {
-	std::set<std::string> SenderNames;
-
 	if (!Sendername || !Sendername[0])
 		return false;
 
@@ -597,8 +768,9 @@ bool spoutSenderNames::SetActiveSender(const char *Sendername)
 	}
 
 	// Get the current list to check whether the passed name is in it
-	if(GetSenderSet(SenderNames)) {
-		if(SenderNames.find(Sendername) != SenderNames.end() ) {
+	const SpoutSenderNameTable* SenderNames = GetSenderNameTable();
+	if(SenderNames) {
+		if(SenderNames->Contains(Sendername)) {
 			if(setActiveSenderName(Sendername)) { // set the active Sender name to shared memory
 				m_senderNames.Unlock();
 				return true;
@@ -660,7 +832,7 @@ bool spoutSenderNames::FindActiveSender(char sendername[SpoutMaxSenderNameLen],
 			strcpy_s(sendername, SpoutMaxSenderNameLen, sname); // pass back sender name
 			theWidth        = (unsigned int)TextureInfo.width;
 			theHeight       = (unsigned int)TextureInfo.height;
-#ifdef _M_X64
+#if defined(_M_X64) || defined(__LP64__)
 			hSharehandle = (HANDLE)(LongToHandle((long)TextureInfo.shareHandle));
 #else
 			hSharehandle = (HANDLE)TextureInfo.shareHandle;
@@ -686,14 +858,27 @@ bool spoutSenderNames::CreateSender(const char *sendername, unsigned int width,
 	SpoutLogNotice("spoutSenderNames::CreateSender");
 	SpoutLogNotice("    [%s] %dx%d, share handle = 0x%.7X, format = %u", sendername, width, height, LOWORD(hSharehandle), dwFormat);
 	
-	// Register the sender name
-	// The function is ignored if the sender already exists
-	RegisterSenderName(sendername);
+	// The name can't be used while another live sender has it. This is
+	// checked first because the info map is written before registering,
+	// after which the name would look like one of ours.
+	if (isSenderNameTaken(sendername)) {
+		SpoutLogWarning("spoutSenderNames::CreateSender - [%s] is used by another sender", sendername);
+		return false;
+	}
+	bool bNewSender = m_senders->find(sendername) == m_senders->end();
 
-	// Save the texture info for this sender
+	// Save the texture info for this sender.
+	// 18.10.26 - The info map is created before the name is registered,
+	// so that an orphan sweep in another process never sees the name
+	// without the info map of a live sender.
 	if(!UpdateSender(sendername, width, height, hSharehandle, dwFormat))
 		return false;
 
+	// Register the sender name
+	// A name left by a sender that has gone is taken over. The function is
+	// ignored if the sender already exists.
+	registerSenderName(sendername, bNewSender);
+
 	return true;
 		
 } // end CreateSender
@@ -712,7 +897,6 @@ bool spoutSenderNames::UpdateSender(const char *sendername, unsigned int width,
 
 		if (result == SPOUT_CREATE_FAILED) {
 			delete senderInfoMem;
-			m_senderNames.Unlock();
 			return false;
 		}
 
@@ -754,30 +938,11 @@ bool spoutSenderNames::UpdateSender(const char *sendername, unsigned int width,
 //
 bool spoutSenderNames::CheckSender(const char *sendername, unsigned int &theWidth, unsigned int &theHeight, HANDLE &hSharehandle, DWORD &dwFormat)
 {
-	SharedTextureInfo info;
-
-	// Is the given sender registered ?
-	if(FindSenderName(sendername)) {
-		// Does it still exist ?
-		if(getSharedInfo(sendername, &info)) {
-			// Return the texture info
-			theWidth     = (unsigned int)info.width;
-			theHeight    = (unsigned int)info.height;
-#ifdef _M_X64
-			hSharehandle = (HANDLE)(LongToHandle((long)info.shareHandle));
-#else
-			hSharehandle = (HANDLE)info.shareHandle;
-#endif			
-			dwFormat		= (DWORD)info.format;
-
-			return true;
-		}
-		else {
-			// Sender is registered but does not exist so close it
-			ReleaseSenderName(sendername);
-		}
+	SpoutLockPolicy policy = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+	SpoutCheckResult result = CheckSender(sendername, policy, theWidth, theHeight, hSharehandle, dwFormat);
 
-	}
+	if (result == SPOUT_CHECK_SUCCESS)
+		return true;
 
 	// Return zero width and height to indicate sender not found
 	theHeight = 0;
@@ -787,6 +952,110 @@ bool spoutSenderNames::CheckSender(const char *sendername, unsigned int &theWidt
 
 } // end CheckSender
 
+//
+// 18.10.26 - Check a sender taking the map locks with the given policy.
+// Returns SPOUT_CHECK_BUSY without waiting further if a lock is held
+// by another thread or process, so that a render thread poll can keep
+// using the information it already has.
+//
+SpoutCheckResult spoutSenderNames::CheckSender(const char *sendername, const SpoutLockPolicy& policy, unsigned int &theWidth, unsigned int &theHeight, HANDLE &hSharehandle, DWORD &dwFormat)
+{
+	SpoutSenderQuery query = {};
+	query.name = sendername;
+
+	CheckSenders(&query, 1, policy);
+
+	if (query.result == SPOUT_CHECK_SUCCESS) {
+		theWidth     = query.width;
+		theHeight    = query.height;
+		hSharehandle = query.handle;
+		dwFormat     = query.format;
+	}
+
+	return query.result;
+
+} // end CheckSender (lock policy)
+
+//
+// 18.10.26 - Check a number of senders with the lock policy.
+// The sender set is read (or taken from the cache) once for all
+// of them, so a process with many receivers doesn't read the map
+// for each one. The result of each sender is set in its query.
+//
+void spoutSenderNames::CheckSenders(SpoutSenderQuery* queries, int count, const SpoutLockPolicy& policy)
+{
+	// Is the sender set available ?
+	SpoutCheckResult result = updateSenderSetCache(policy);
+
+	for (int i = 0; i < count; i++) {
+		if (result == SPOUT_CHECK_SUCCESS)
+			checkCachedSender(queries[i], policy);
+		else
+			queries[i].result = result;
+	}
+
+} // end CheckSenders
+
+// Check a sender against the sender set cache and read its info
+void spoutSenderNames::checkCachedSender(SpoutSenderQuery& query, const SpoutLockPolicy& policy)
+{
+	SharedTextureInfo info;
+
+	if (!query.name || !query.name[0]) {
+		query.result = SPOUT_CHECK_FAILED;
+		return;
+	}
+
+	// Is the given sender registered ?
+	if (!m_senderSetCache->Contains(query.name)) {
+		// Not registered - don't keep the info map of a released sender open
+		releaseSharedInfo(query.name);
+		query.result = SPOUT_CHECK_FAILED;
+		return;
+	}
+
+	// Has the info changed since the last check ?
+	// The sequence word is bumped on every info write, so a single read of
+	// it is enough for senders that publish one. The cached map is still
+	// counted as a read, so that it is re-opened to detect a crashed sender.
+	if (query.stamp) {
+		auto found = m_infoCache->find(query.name);
+		if (found != m_infoCache->end() && found->second.reads < SpoutInfoCacheReopenCount) {
+			volatile LONG* seq = (volatile LONG*)&((SharedTextureInfo*)found->second.map->Buffer())->usage;
+			if ((DWORD)InterlockedCompareExchange(seq, 0, 0) == query.stamp) {
+				found->second.reads++;
+				query.result = SPOUT_CHECK_UNCHANGED;
+				return;
+			}
+		}
+	}
+
+	// Does it still exist ?
+	query.result = readSharedInfo(query.name, &info, policy);
+	query.stamp = 0;
+
+	if (query.result == SPOUT_CHECK_SUCCESS) {
+		// Stamp for the next check, only for senders with a sequence word
+		if ((info.usage & 0xFFFF0000) == SpoutInfoSeqMagic && !(info.usage & 1))
+			query.stamp = info.usage;
+		// Return the texture info
+		query.width  = (unsigned int)info.width;
+		query.height = (unsigned int)info.height;
+#if defined(_M_X64) || defined(__LP64__)
+		query.handle = (HANDLE)(LongToHandle((long)info.shareHandle));
+#else
+		query.handle = (HANDLE)info.shareHandle;
+#endif
+		query.format = (DWORD)info.format;
+		query.flags  = (DWORD)(info.partnerId & SpoutInfoBottomUp);
+	}
+	else if (query.result == SPOUT_CHECK_FAILED && !m_bDeferredCleanup) {
+		// Sender is registered but does not exist so close it
+		ReleaseSenderName(query.name);
+	}
+
+}
+
 // Find a sender and return the name, width and height, sharhandle and format
 bool spoutSenderNames::FindSender(char *sendername, unsigned int &width, unsigned int &height, HANDLE &hSharehandle, DWORD &dwFormat)
 {
@@ -813,7 +1082,7 @@ bool spoutSenderNames::FindSender(char *sendername, unsigned int &width, unsigne
 	if (getSharedInfo(sendername, &info)) {
 		width = (unsigned int)info.width; // pass back sender size
 		height = (unsigned int)info.height;
-#ifdef _M_X64
+#if defined(_M_X64) || defined(__LP64__)
 		hSharehandle = (HANDLE)(LongToHandle((long)info.shareHandle));
 #else
 		hSharehandle = (HANDLE)info.shareHandle;
@@ -841,35 +1110,158 @@ bool spoutSenderNames::GetSender(const char* sendername)
 // in the sender list but the shared memory info does not
 void spoutSenderNames::CleanSenders()
 {
-	char name[512];
-	std::set<std::string> Senders;
-	std::set<std::string>::iterator iter;
-	std::string namestring;
-	SharedTextureInfo info;
+	// Removes the names whose info map doesn't exist with the set locked once
+	cleanSenderSet();
+
+}
+
+void spoutSenderNames::SetDeferredCleanup(bool bDeferred)
+{
+	m_bDeferredCleanup = bDeferred;
+}
+
+bool spoutSenderNames::GetDeferredCleanup()
+{
+	return m_bDeferredCleanup;
+}
+
+//
+// 18.10.26 - Release orphaned senders for a background sweep.
+// The info maps are opened without the sender set locked, then the set is
+// locked once within the policy to remove the names that are still orphaned.
+// Names registered by this object are never removed.
+//
+int spoutSenderNames::SweepOrphans(const SpoutLockPolicy& policy)
+{
+	std::vector<std::string> orphans;
+
+	if (updateSenderSetCache(policy) != SPOUT_CHECK_SUCCESS)
+		return 0;
+
+	for (int i = 0; i < m_senderSetCache->Size(); i++) {
+		std::string namestring((*m_senderSetCache)[i]);
+		if (m_senders->find(namestring) != m_senders->end())
+			continue;
+		// A cached info map would keep the map of a legacy sender open
+		releaseSharedInfo(namestring.c_str());
+		if (!senderExists(namestring.c_str()))
+			orphans.push_back(namestring);
+	}
+
+	if (orphans.empty())
+		return 0;
+
+	char *pBuf = m_senderNames.Lock(policy);
+	if (!pBuf)
+		return 0; // Try again on the next sweep
+
+	SpoutSenderNameTable& SenderNames = *m_senderSetWork;
+	readSenderSet(pBuf, SenderNames);
 
-	// get the sender name list in shared memory into a local list
-	GetSenderNames(&Senders);
-
-	// Now we have a local set of names "Senders"
-	// Run through the set and check whether the sender exists
-	// If it does not exist, release from the sender list
-	if (Senders.size() > 0) {
-		for (iter = Senders.begin(); iter != Senders.end(); iter++) {
-			namestring = *iter; // the Sender name string
-			strcpy_s(name, namestring.c_str());
-
-			// we have the name already, so look for it's info
-			if (!getSharedInfo(name, &info)) {
-				// Sender does not exist any more so release from the name list
-				ReleaseSenderName(name);
+	// The name may have been registered again since the check
+	int released = 0;
+	for (const std::string& namestring : orphans) {
+		if (SenderNames.Contains(namestring.c_str()) && !senderExists(namestring.c_str())) {
+			SenderNames.Erase(namestring.c_str());
+			released++;
+		}
+	}
+
+	if (released > 0) {
+		writeSenderSet(SenderNames, pBuf);
+		bumpSenderSetGeneration();
+		// Make the first sender active if the active one was released
+		char name[SpoutMaxSenderNameLen];
+		if (SenderNames.Size() > 0 &&
+			(!getActiveSenderName(name) || !SenderNames.Contains(name))) {
+			std::string_view first = SenderNames[0];
+			first.copy(name, SpoutMaxSenderNameLen - 1);
+			name[first.size()] = 0;
+			setActiveSenderName(name);
+		}
+	}
+
+	m_senderNames.Unlock();
+
+	return released;
+
+} // end SweepOrphans
+
+//
+// 18.10.26 - Consistency check of the shared sender set.
+// The slots are scanned as they are in the map (including the extension
+// segments) because readSenderSet would hide duplicates.
+//
+int spoutSenderNames::ValidateSenderSet()
+{
+	if (!CreateSenderSet())
+		return 0;
+
+	char *pBuf = m_senderNames.Lock();
+	if (!pBuf)
+		return 0;
+
+	int problems = 0;
+	int count = 0;
+	const char* previous = NULL;
+	bool active = false;
+	char activename[SpoutMaxSenderNameLen];
+	bool hasActive = getActiveSenderName(activename) && activename[0];
+
+	const char* segment = pBuf;
+	int slots = m_senderSetSlots;
+	int segments = getSenderSetSegments();
+	if (segments < 0 || segments > SpoutMaxSenderNameSegments)
+		segments = SpoutMaxSenderNameSegments;
+
+	for (int s = 0; segment; s++) {
+		int i = 0;
+		for (; i < slots && segment[i * SpoutMaxSenderNameLen]; i++) {
+			const char* name = segment + i * SpoutMaxSenderNameLen;
+			if (previous) {
+				int order = strncmp(previous, name, SpoutMaxSenderNameLen);
+				if (order == 0) {
+					SpoutLogWarning("spoutSenderNames::ValidateSenderSet - duplicate name [%s]", name);
+					problems++;
+				}
+				else if (order > 0) {
+					SpoutLogWarning("spoutSenderNames::ValidateSenderSet - name out of order [%s]", name);
+					problems++;
+				}
 			}
+			if (hasActive && strncmp(activename, name, SpoutMaxSenderNameLen) == 0)
+				active = true;
+			previous = name;
+			count++;
+		}
+		// The segments are read after the first map whether it is full or not.
+		// The list ends in the first segment that isn't full.
+		if ((s > 0 && i < SpoutSenderNameSegmentSlots) || s == segments)
+			break;
+		const char* next = senderSetSegment(s + 1, false);
+		if (!next)
+			break;
+		const SpoutSenderSetSegmentHeader* header = (const SpoutSenderSetSegmentHeader*)next;
+		if (header->magic != SpoutSenderSetSegmentMagic || header->count > SpoutSenderNameSegmentSlots) {
+			SpoutLogWarning("spoutSenderNames::ValidateSenderSet - invalid segment %d header", s + 1);
+			problems++;
+			break;
 		}
+		segment = next + SpoutMaxSenderNameLen;
+		slots = (int)header->count;
+	}
+
+	if (count > 0 && hasActive && !active) {
+		SpoutLogWarning("spoutSenderNames::ValidateSenderSet - active sender [%s] is not registered", activename);
+		problems++;
 	}
 
-	// Now we have cleaned up the list in shared memory
-	Senders.clear();
+	m_senderNames.Unlock();
+
+	return problems;
+
+} // end ValidateSenderSet
 
-}
 // ================================================
 
 
@@ -907,13 +1299,10 @@ void spoutSenderNames::readSenderSetFromBuffer(const char* buffer, std::set<std:
 
 void spoutSenderNames::writeBufferFromSenderSet(const std::set<std::string>& SenderNames, char* buffer, int maxSenders)
 {
-	std::string namestring;
 	char *buf = buffer; // pointer within the buffer
 	int i = 0;
-	std::set<std::string>::iterator iter;
 
-	for(iter = SenderNames.begin(); iter != SenderNames.end(); iter++) {
-		namestring = *iter; // the string to copy to the buffer
+	for(const std::string& namestring : SenderNames) {
 		// copy it with 256 max length although only the string length will be copied
 		strcpy_s(buf, SpoutMaxSenderNameLen, namestring.c_str());
 		// move the buffer pointer on for the next Sender name
@@ -932,6 +1321,209 @@ void spoutSenderNames::writeBufferFromSenderSet(const std::set<std::string>& Sen
 	}
 }
 
+//
+// 18.10.26 - Sender set extension segments
+// The sorted list fills the first map up to senderSetFirstMapLimit and
+// continues in the segments. The segments are always merged with the
+// first map, which applications that don't know about them may have
+// changed. The header of a segment holds the number of names in it, and
+// the list ends in the first segment that isn't full.
+//
+void spoutSenderNames::readSenderSet(const char* pBuf, SpoutSenderNameTable& SenderNames)
+{
+	SenderNames.Parse(pBuf, m_senderSetSlots, SpoutMaxSenderNameLen);
+
+	// The segments are looked for if the number in use isn't published
+	int segments = getSenderSetSegments();
+	if (segments < 0 || segments > SpoutMaxSenderNameSegments)
+		segments = SpoutMaxSenderNameSegments;
+
+	for (int i = 1; i <= segments; i++) {
+		const char* segment = senderSetSegment(i, false);
+		if (!segment) break;
+		const SpoutSenderSetSegmentHeader* header = (const SpoutSenderSetSegmentHeader*)segment;
+		if (header->magic != SpoutSenderSetSegmentMagic) break;
+		int count = (int)header->count;
+		if (count > SpoutSenderNameSegmentSlots) count = SpoutSenderNameSegmentSlots;
+		SenderNames.ParseSegment(segment + SpoutMaxSenderNameLen, count, SpoutMaxSenderNameLen);
+		if (count < SpoutSenderNameSegmentSlots) break;
+	}
+
+} // end readSenderSet
+
+bool spoutSenderNames::writeSenderSet(const SpoutSenderNameTable& SenderNames, char* pBuf)
+{
+	// The first map is the one seen by all applications
+	int written = SenderNames.Write(pBuf, senderSetFirstMapLimit(), SpoutMaxSenderNameLen);
+
+	// The list is terminated in the first map if it has room left
+	// and the segments aren't used
+	if (written < m_senderSetSlots)
+		pBuf[written * SpoutMaxSenderNameLen] = 0;
+
+	// Segments are only created or written for names that remain
+	bool published = getSenderSetSegments() >= 0;
+	int segments = 0;
+
+	for (int i = 1; i <= SpoutMaxSenderNameSegments; i++) {
+		bool remaining = written < SenderNames.Size();
+		if (!remaining && published)
+			break;
+		// Without the published number, readers look for the segments,
+		// so the next existing one is emptied.
+		char* segment = senderSetSegment(i, remaining);
+		if (!segment) {
+			if (!remaining)
+				break;
+			SpoutLogError("spoutSenderNames::writeSenderSet - could not create segment %d", i);
+			break;
+		}
+		int count = SenderNames.Write(segment + SpoutMaxSenderNameLen, SpoutSenderNameSegmentSlots, SpoutMaxSenderNameLen, written);
+		SpoutSenderSetSegmentHeader* header = (SpoutSenderSetSegmentHeader*)segment;
+		header->magic = SpoutSenderSetSegmentMagic;
+		header->count = (DWORD)count;
+		written += count;
+		if (count > 0)
+			segments = i;
+		if (count < SpoutSenderNameSegmentSlots)
+			break;
+	}
+
+	setSenderSetSegments(segments);
+
+	return written == SenderNames.Size();
+
+} // end writeSenderSet
+
+int spoutSenderNames::senderSetCapacity()
+{
+	return senderSetFirstMapLimit() + SpoutMaxSenderNameSegments * SpoutSenderNameSegmentSlots;
+}
+
+// An eighth of the first map (at least one slot) is left
+// for applications that don't use the segments
+int spoutSenderNames::senderSetFirstMapLimit()
+{
+	if (m_senderSetSlots <= 1)
+		return m_senderSetSlots;
+	int headroom = m_senderSetSlots / 8;
+	return m_senderSetSlots - (headroom > 1 ? headroom : 1);
+}
+
+char* spoutSenderNames::senderSetSegment(int index, bool bCreate)
+{
+	while ((int)m_senderSetSegments->size() < index)
+		m_senderSetSegments->push_back(new SpoutSharedMemory());
+
+	SpoutSharedMemory* segment = (*m_senderSetSegments)[index - 1];
+
+	// Already open. The handle is kept so that the segment stays
+	// alive while this process uses the sender set.
+	if (segment->Buffer())
+		return segment->Buffer();
+
+	char name[64];
+	sprintf_s(name, 64, "SpoutSenderNamesSegment%d", index);
+
+	// Header and names
+	if (bCreate) {
+		if (segment->Create(name, (SpoutSenderNameSegmentSlots + 1) * SpoutMaxSenderNameLen) == SPOUT_CREATE_FAILED)
+			return NULL;
+	}
+	else if (!segment->Open(name)) {
+		return NULL;
+	}
+
+	return segment->Buffer();
+
+} // end senderSetSegment
+
+//
+// Lock-free read of sender info written by writeSharedInfoBuffer.
+// Returns false if the writer does not publish a sequence word
+// or if a consistent copy could not be made within SpoutInfoSeqRetries,
+// in which case the caller has to read under the map mutex.
+//
+bool spoutSenderNames::readSharedInfoBuffer(const char* buffer, SharedTextureInfo* info)
+{
+	if (!buffer) return false;
+
+	volatile LONG* seq = (volatile LONG*)&((SharedTextureInfo*)buffer)->usage;
+
+	for (int i = 0; i < SpoutInfoSeqRetries; i++) {
+		DWORD before = (DWORD)*seq;
+		MemoryBarrier();
+
+		// Legacy writer - the mutex has to be used
+		if ((before & 0xFFFF0000) != SpoutInfoSeqMagic)
+			return false;
+
+		// Write in progress
+		if (before & 1) {
+			YieldProcessor();
+			continue;
+		}
+
+		__movsd((unsigned long *)info, (unsigned long const *)buffer, sizeof(SharedTextureInfo) / 4); // 280 bytes
+
+		MemoryBarrier();
+		if ((DWORD)*seq == before)
+			return true;
+	}
+
+	return false;
+
+} // end readSharedInfoBuffer
+
+//
+// Write sender info with the sequence word.
+// The map mutex must be held so that legacy readers stay consistent.
+//
+void spoutSenderNames::writeSharedInfoBuffer(char* buffer, const SharedTextureInfo* info)
+{
+	volatile LONG* seq = (volatile LONG*)&((SharedTextureInfo*)buffer)->usage;
+
+	DWORD count = (DWORD)*seq;
+	if ((count & 0xFFFF0000) != SpoutInfoSeqMagic)
+		count = SpoutInfoSeqMagic;
+	count &= 0xFFFE; // even when idle
+
+	DWORD writing = SpoutInfoSeqMagic | ((count + 1) & 0xFFFF);
+	DWORD written = SpoutInfoSeqMagic | ((count + 2) & 0xFFFF);
+
+	SharedTextureInfo temp = *info;
+	temp.usage = writing;
+
+	InterlockedExchange(seq, (LONG)writing);
+	__movsd((unsigned long *)buffer, (unsigned long const *)&temp, sizeof(SharedTextureInfo) / 4); // 280 bytes
+	InterlockedExchange(seq, (LONG)written);
+
+} // end writeSharedInfoBuffer
+
+// Write the first four fields of the info with the sequence word
+// The rest of the map is not touched
+void spoutSenderNames::writeSharedInfoFields(char* buffer, const SharedTextureInfo* info)
+{
+	SharedTextureInfo* shared = (SharedTextureInfo*)buffer;
+	volatile LONG* seq = (volatile LONG*)&shared->usage;
+
+	DWORD count = (DWORD)*seq;
+	if ((count & 0xFFFF0000) != SpoutInfoSeqMagic)
+		count = SpoutInfoSeqMagic;
+	count &= 0xFFFE; // even when idle
+
+	DWORD writing = SpoutInfoSeqMagic | ((count + 1) & 0xFFFF);
+	DWORD written = SpoutInfoSeqMagic | ((count + 2) & 0xFFFF);
+
+	InterlockedExchange(seq, (LONG)writing);
+	shared->shareHandle = info->shareHandle;
+	shared->width       = info->width;
+	shared->height      = info->height;
+	shared->format      = info->format;
+	InterlockedExchange(seq, (LONG)written);
+
+} // end writeSharedInfoFields
+
 //
 //  Functions to read and write the list of Sender names to/from shared memory
 //
@@ -950,42 +1542,111 @@ bool spoutSenderNames::CreateSenderSet()
 		SpoutLogError("spoutSenderNames::CreateSenderSet() : SPOUT_CREATE_FAILED");
 		return false;
 	}
+
+	// The names that fit in the map as it was created,
+	// rather than m_MaxSenders of this application
+	if (m_senderSetSlots == 0)
+		m_senderSetSlots = m_senderNames.Capacity() / SpoutMaxSenderNameLen;
+
+	// Sender set generation - optional, readers re-read the set without it
+	// The second word is the number of extension segments in use.
+	m_senderGeneration.Create("SpoutSenderNamesGeneration", 2 * sizeof(LONG));
+
 	return true;
 
 } // end CreateSenderSet
 
 bool spoutSenderNames::GetSenderSet(std::set<std::string>& SenderNames) {
 
-	std::set<std::string>::iterator iter;
-	char* pBuf = NULL;
+	SpoutLockPolicy policy = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+
+	// Re-read the set from the map only if it has changed
+	if (updateSenderSetCache(policy) != SPOUT_CHECK_SUCCESS) {
+		return false;
+	}
+
+	SenderNames.clear();
+	for (int i = 0; i < m_senderSetCache->Size(); i++)
+		SenderNames.emplace((*m_senderSetCache)[i]);
+
+	return true;
+
+} // end GetSenderSet
+
+// Current generation of the sender set, 0 if the generation map is not there
+DWORD spoutSenderNames::getSenderSetGeneration()
+{
+	volatile LONG* generation = (volatile LONG*)m_senderGeneration.Buffer();
+	if (!generation) return 0;
+	return (DWORD)InterlockedCompareExchange(generation, 0, 0);
+}
+
+// Number of extension segments in use, after the generation.
+// -1 if the generation map is not there.
+// Must be called with the sender set map locked.
+int spoutSenderNames::getSenderSetSegments()
+{
+	volatile LONG* generation = (volatile LONG*)m_senderGeneration.Buffer();
+	if (!generation || m_senderGeneration.Capacity() < 2 * (int)sizeof(LONG)) return -1;
+	return (int)generation[1];
+}
+
+void spoutSenderNames::setSenderSetSegments(int segments)
+{
+	volatile LONG* generation = (volatile LONG*)m_senderGeneration.Buffer();
+	if (!generation || m_senderGeneration.Capacity() < 2 * (int)sizeof(LONG)) return;
+	generation[1] = (LONG)segments;
+}
+
+// Record a change of the sender set
+// Must be called with the sender set map locked
+void spoutSenderNames::bumpSenderSetGeneration()
+{
+	volatile LONG* generation = (volatile LONG*)m_senderGeneration.Buffer();
+	if (generation) InterlockedIncrement(generation);
+	m_senderSetCacheValid = false;
+}
 
+//
+// Parse the sender set map into m_senderSetCache unless
+// the generation is the same as when it was last parsed.
+// The cache is also re-read every SpoutSenderSetRevalidateTime msec
+// to pick up changes made by applications that don't bump the generation.
+//
+SpoutCheckResult spoutSenderNames::updateSenderSetCache(const SpoutLockPolicy& policy)
+{
 	// Open or create m_sendernames
 	if (!CreateSenderSet())	{
-		return false;
+		return SPOUT_CHECK_FAILED;
 	}
 
-	pBuf = m_senderNames.Lock();
+	if (m_senderSetCacheValid
+		&& GetTickCount64() - m_senderSetCacheTime < SpoutSenderSetRevalidateTime
+		&& m_senderGeneration.Buffer()
+		&& getSenderSetGeneration() == m_senderSetCacheGeneration) {
+		return SPOUT_CHECK_SUCCESS;
+	}
+
+	char* pBuf = m_senderNames.Lock(policy);
 	if (!pBuf) {
-		return false;
+		return SPOUT_CHECK_BUSY;
 	}
 
+	// The generation is bumped with the map locked,
+	// so this matches the contents read below.
+	m_senderSetCacheGeneration = getSenderSetGeneration();
+
 	// The data has been stored with 256 bytes reserved for each Sender name
-	// and nothing will have changed with the map yet
-	if(pBuf[0] == 0) { // no senders yet
-		m_senderNames.Unlock();
-		return true;
-	}
+	readSenderSet(pBuf, *m_senderSetCache);
 
-	// Read back from the mapped memory buffer and rebuild the set that was passed in
-	// The set will then contain the senders currently in the memory map
-	// and allow for any that have been added or deleted
-	readSenderSetFromBuffer(pBuf, SenderNames, m_MaxSenders);
+	m_senderSetCacheTime = GetTickCount64();
+	m_senderSetCacheValid = true;
 
 	m_senderNames.Unlock();
 
-	return true;
+	return SPOUT_CHECK_SUCCESS;
 
-} // end GetSenderSet
+} // end updateSenderSetCache
 
 // Create a shared memory map to set the active Sender name to shared memory
 // This is a separate small shared memory with a fixed sharing name
@@ -1038,22 +1699,94 @@ bool spoutSenderNames::getActiveSenderName(char SenderName[SpoutMaxSenderNameLen
 // A receiver checks this all the time so it has to be compact
 // Does not have to be the info of this instance
 // so the creation pointer and handle may not be known
+//
+// 18.10.26 - The info map is opened once and kept in m_infoCache.
+// An open handle keeps the map alive after the sender has closed or crashed,
+// and with more than one receiving process re-opening it doesn't help
+// because the others keep it open. So the sender process published in the
+// info is checked every SpoutInfoCacheReopenCount reads, and the map is
+// dropped when that process has gone. For legacy senders that don't
+// publish it, the map is re-opened instead (SpoutSharedMemory::Reopen,
+// which doesn't remap it with the POSIX backend).
+//
 bool spoutSenderNames::getSharedInfo(const char* sharedMemoryName, SharedTextureInfo* info) 
 {
-	SpoutSharedMemory mem;
+	SpoutLockPolicy policy = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+	return readSharedInfo(sharedMemoryName, info, policy) == SPOUT_CHECK_SUCCESS;
 
-	// Possibly faster because the function is called all the time
-	if(mem.Open(sharedMemoryName)) {
-		char *pBuf = mem.Lock();
-		if(pBuf) {
-			__movsd((unsigned long *)info, (unsigned long const *)pBuf, sizeof(SharedTextureInfo) / 4); // 280 bytes
-			mem.Unlock();
-			return true;
+} // end getSharedInfo
+
+// getSharedInfo with a lock policy for the fallback mutex read.
+// Returns SPOUT_CHECK_BUSY if the map exists but its lock was not taken.
+SpoutCheckResult spoutSenderNames::readSharedInfo(const char* sharedMemoryName, SharedTextureInfo* info, const SpoutLockPolicy& policy)
+{
+	if (!sharedMemoryName || !sharedMemoryName[0])
+		return SPOUT_CHECK_FAILED;
+
+	auto found = m_infoCache->find(sharedMemoryName);
+
+	if (found != m_infoCache->end() && found->second.reads >= SpoutInfoCacheReopenCount
+		&& !found->second.processId) {
+		// Time to check that a legacy sender still exists
+		if (!found->second.map->Reopen()) {
+			delete found->second.map;
+			m_infoCache->erase(found);
+			return SPOUT_CHECK_FAILED;
 		}
 	}
-	return false;
 
-} // end getSharedInfo
+	if (found == m_infoCache->end()) {
+		SpoutSharedMemory *mem = new SpoutSharedMemory();
+		if (!mem->Open(sharedMemoryName)) {
+			delete mem;
+			return SPOUT_CHECK_FAILED;
+		}
+		size_t length = strlen(sharedMemoryName);
+		std::unique_ptr<char[]> name(new char[length + 1]);
+		memcpy(name.get(), sharedMemoryName, length + 1);
+		std::string_view key(name.get(), length);
+		found = m_infoCache->emplace(key, SharedInfoCacheEntry{ mem, SpoutInfoCacheReopenCount, 0, std::move(name) }).first;
+	}
+
+	// Senders that publish a sequence word can be read without the mutex
+	if (!readSharedInfoBuffer(found->second.map->Buffer(), info)) {
+		char *pBuf = found->second.map->Lock(policy);
+		if (!pBuf) {
+			// Lock timeout - the map is still valid so keep it
+			return SPOUT_CHECK_BUSY;
+		}
+		__movsd((unsigned long *)info, (unsigned long const *)pBuf, sizeof(SharedTextureInfo) / 4); // 280 bytes
+		found->second.map->Unlock();
+	}
+
+	// Time to check that the sender process is still running
+	if (found->second.reads >= SpoutInfoCacheReopenCount) {
+		DWORD processId = getSenderProcessId(info);
+		if (processId && !isProcessRunning(processId)) {
+			delete found->second.map;
+			m_infoCache->erase(found);
+			return SPOUT_CHECK_FAILED;
+		}
+		found->second.processId = processId;
+		found->second.reads = 0;
+	}
+
+	found->second.reads++;
+
+	return SPOUT_CHECK_SUCCESS;
+
+} // end readSharedInfo
+
+// Close the cached info map of a sender
+void spoutSenderNames::releaseSharedInfo(const char* sharedMemoryName)
+{
+	auto found = m_infoCache->find(sharedMemoryName);
+	if (found != m_infoCache->end()) {
+		delete found->second.map;
+		m_infoCache->erase(found);
+	}
+
+} // end releaseSharedInfo
 
 // 12.06.15 - Added to allow direct modification of a sender's information in shared memory
 bool spoutSenderNames::setSharedInfo(const char* sharedMemoryName, SharedTextureInfo* info) 
@@ -1071,13 +1804,13 @@ bool spoutSenderNames::setSharedInfo(const char* sharedMemoryName, SharedTexture
 		return false;
 	}
 
-	__movsd((unsigned long *)pBuf, (unsigned long const *)info, sizeof(SharedTextureInfo) / 4); // 280 bytes
+	writeSharedInfoBuffer(pBuf, info);
 
 	mem.Unlock();
 	
 	return true;
 
-} // end getSharedInfo
+} // end setSharedInfo
 
 
 // Test for shared info memory map existence
@@ -1095,3 +1828,101 @@ bool spoutSenderNames::hasSharedInfo(const char* sharedMemoryName)
 
 } // end hasSharedInfo
 
+// Test that a sender exists without the info cache.
+// A map opened by any process stays after its sender has crashed,
+// so the sender process is checked as well if it is published.
+bool spoutSenderNames::senderExists(const char* sendername)
+{
+	DWORD processId = 0;
+	if (!readSenderProcessId(sendername, processId))
+		return false;
+
+	return !processId || isProcessRunning(processId);
+
+} // end senderExists
+
+// Test that a name is used by another live sender.
+// The info map is written by CreateSender before the name is registered,
+// so a sender of this object finds its own process in it, and a sender
+// that takes over the name of a crashed one finds the crashed process
+// (or no map at all) before that.
+bool spoutSenderNames::isSenderNameTaken(const char* sendername)
+{
+	DWORD processId = 0;
+	if (!readSenderProcessId(sendername, processId))
+		return false; // No info map
+
+	if (!processId)
+		return true; // Legacy sender or busy map
+
+	// Another sender object of this process
+	if (processId == GetCurrentProcessId())
+		return m_senders->find(sendername) == m_senders->end();
+
+	return isProcessRunning(processId);
+
+} // end isSenderNameTaken
+
+bool spoutSenderNames::readSenderProcessId(const char* sendername, DWORD& processId)
+{
+	processId = 0;
+
+	SpoutSharedMemory mem;
+	if (!mem.Open(sendername))
+		return false;
+
+	SharedTextureInfo info;
+	if (!readSharedInfoBuffer(mem.Buffer(), &info)) {
+		char *pBuf = mem.Lock();
+		if (!pBuf)
+			return true; // Exists but busy
+		__movsd((unsigned long *)&info, (unsigned long const *)pBuf, sizeof(SharedTextureInfo) / 4); // 280 bytes
+		mem.Unlock();
+	}
+
+	processId = getSenderProcessId(&info);
+	return true;
+
+} // end readSenderProcessId
+
+//
+// 18.10.26 - Sender process ID in the last 8 bytes of the description,
+// after the host path. Not set if the path doesn't leave room for it.
+//
+DWORD spoutSenderNames::getSenderProcessId(const SharedTextureInfo* info)
+{
+	const char* tail = (const char*)info->description + sizeof(info->description) - 8;
+	DWORD magic, processId;
+	memcpy(&magic, tail, 4);
+	memcpy(&processId, tail + 4, 4);
+	return magic == SpoutInfoProcessMagic ? processId : 0;
+}
+
+void spoutSenderNames::setSenderProcessId(SharedTextureInfo* info, DWORD processId)
+{
+	char* description = (char*)info->description;
+	char* tail = description + sizeof(info->description) - 8;
+	if (strnlen(description, sizeof(info->description)) >= sizeof(info->description) - 8)
+		return; // The path is too long
+	DWORD magic = SpoutInfoProcessMagic;
+	memcpy(tail, &magic, 4);
+	memcpy(tail + 4, &processId, 4);
+}
+
+// Check if a process is still running.
+// A process that can't be queried is taken as running.
+bool spoutSenderNames::isProcessRunning(DWORD processId)
+{
+#ifdef _WIN32
+	HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+	if (!hProcess)
+		return GetLastError() == ERROR_ACCESS_DENIED;
+	DWORD exitCode = 0;
+	BOOL bResult = GetExitCodeProcess(hProcess, &exitCode);
+	CloseHandle(hProcess);
+	return !bResult || exitCode == STILL_ACTIVE;
+#else
+	return kill((pid_t)processId, 0) == 0 || errno == EPERM;
+#endif
+}
+
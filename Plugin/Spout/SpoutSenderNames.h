@@ -36,19 +36,24 @@
 #ifndef __spoutSenderNames__ // standard way as well
 #define __spoutSenderNames__
 
+#ifdef _WIN32
 #include <windowsx.h>
 #include <d3d9.h>
 #include <d3d11.h>
 #include <wingdi.h>
+#include <intrin.h> // for __movsd
+#endif
 #include <set>
 #include <map>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
-#include <intrin.h> // for __movsd
 
 #include "SpoutCommon.h"
 #include "SpoutSharedMemory.h"
+#include "SpoutSenderNameTable.h"
 
 using namespace spoututils;
 
@@ -58,6 +63,45 @@ using namespace spoututils;
 // MaxSenders define replaced by a global class variable (Maximum for list of Sender names)
 #define SpoutMaxSenderNameLen 256
 
+// Sequence word marker in SharedTextureInfo::usage
+#define SpoutInfoSeqMagic 0x53510000
+
+// Bit in SharedTextureInfo::partnerId (below the CPU and GL/DX bits of
+// SetSenderID) : the texture rows are in bottom-up order. Receivers that
+// don't check it show such a frame upside down.
+#define SpoutInfoBottomUp 0x20000000
+
+// Lock-free read attempts before falling back to the map mutex
+#define SpoutInfoSeqRetries 64
+
+// Time the sender set is served from the cache before it is re-read (msec).
+// Legacy applications change the sender set without bumping the generation.
+#define SpoutSenderSetRevalidateTime 500
+
+// Sender set extension beyond the first map.
+// Names that don't fit in "SpoutSenderNames" continue in the extension
+// segments "SpoutSenderNamesSegment1", "SpoutSenderNamesSegment2", ...
+// of SpoutSenderNameSegmentSlots names each, locked with the first map.
+// Applications that don't know about them see the first map only, so
+// some slots of the first map are left for their registrations.
+// The first slot of a segment holds a SpoutSenderSetSegmentHeader.
+#define SpoutSenderNameSegmentSlots 1024
+#define SpoutMaxSenderNameSegments 15
+#define SpoutSenderSetSegmentMagic 0x53474553 // "SEGS"
+
+struct SpoutSenderSetSegmentHeader {
+	DWORD magic; // SpoutSenderSetSegmentMagic
+	DWORD count; // Number of names in the segment
+};
+
+// Number of getSharedInfo reads served by a cached sender info map
+// before the sender is checked again : its process if it is published
+// in the info, otherwise by closing and re-opening the map
+#define SpoutInfoCacheReopenCount 60
+
+// Marker of the sender process ID at the end of the description field
+#define SpoutInfoProcessMagic 0x44495053 // "SPID"
+
 // The texture information structure that is saved to shared memory
 // and used for communication between senders and receivers
 // unsigned __int32 is used for compatibility between 32bit and 64bit
@@ -70,17 +114,59 @@ using namespace spoututils;
 // https://msdn.microsoft.com/en-us/library/aa384267%28VS.85%29.aspx
 // in SpoutGLDXinterop.cpp and SpoutSenderNames
 //
+// 18.10.26 - The unused "usage" field carries a sequence word so that
+// receivers can read the structure without taking the map mutex.
+// Writers that know the protocol set the upper 16 bits to SpoutInfoSeqMagic
+// and make the lower 16 bits odd while the structure is being written.
+// Legacy writers leave it zero, in which case readers fall back to the mutex.
+//
+// 18.10.26 - The last 8 bytes of the description hold SpoutInfoProcessMagic
+// and the ID of the sender process if the host path is short enough,
+// so that a crashed sender can be detected while other processes still
+// have its info map open. Legacy readers stop at the end of the path.
+//
 struct SharedTextureInfo {			// 280 bytes total
 	unsigned __int32 shareHandle;	// 4 bytes : texture handle
 	unsigned __int32 width;			// 4 bytes : texture width
 	unsigned __int32 height;		// 4 bytes : texture height
 	DWORD format;					// 4 bytes : texture pixel format
-	DWORD usage;					// 4 bytes : not used
+	DWORD usage;					// 4 bytes : sequence word (see above)
 	wchar_t description[128];		// 256 bytes : Wyphon compatible description (not used)
 	unsigned __int32 partnerId;		// 4 bytes : Wyphon id of partner that shared it with us (not used)
 };
 
 
+// Result of a sender check with a lock policy
+enum SpoutCheckResult {
+	SPOUT_CHECK_FAILED = 0, // Sender not found
+	SPOUT_CHECK_SUCCESS,
+	SPOUT_CHECK_BUSY, // A map lock could not be taken within the policy
+	SPOUT_CHECK_UNCHANGED, // CheckSenders : same info as the stamp passed in
+};
+
+// Sender check entry for CheckSenders
+struct SpoutSenderQuery {
+	const char* name; // in : sender name
+	unsigned int width; // out : texture info on SPOUT_CHECK_SUCCESS
+	unsigned int height;
+	HANDLE handle;
+	DWORD format;
+	DWORD flags; // out : SpoutInfoBottomUp if set
+	DWORD stamp; // in/out : info sequence word from the last check, 0 if none
+	SpoutCheckResult result; // out
+};
+
+// Sender entry of GetSenderSnapshot
+struct SpoutSenderSnapshot {
+	int nameOffset; // Name position in the name buffer (null terminated)
+	int nameLength; // 0 if the name did not fit in the name buffer
+	unsigned int width;
+	unsigned int height;
+	DWORD format;
+	unsigned __int32 shareHandle;
+	DWORD stamp; // Changes on every info update, 0 for a legacy sender
+};
+
 class SPOUT_DLLEXP spoutSenderNames {
 
 	public:
@@ -109,10 +195,35 @@ class SPOUT_DLLEXP spoutSenderNames {
 
 		// Retrieve the sender name list as a set of names
 		bool GetSenderNames(std::set<std::string> *sendernames);
+		// Retrieve the sender name list without copying it.
+		// The table is valid until the next call to this class.
+		const SpoutSenderNameTable* GetSenderNameTable();
 		// Number of senders in the list
 		int  GetSenderCount();
 		// Information about a sender from an index into the list
 		bool GetSenderNameInfo(int index, char* sendername, int sendernameMaxSize, unsigned int &width, unsigned int &height, HANDLE &dxShareHandle);
+		// Names and texture info of all senders with the sender set locked once.
+		// Fills up to "capacity" entries and returns the number of senders.
+		// A name buffer of capacity * SpoutMaxSenderNameLen bytes fits all names.
+		int GetSenderSnapshot(SpoutSenderSnapshot* entries, int capacity, char* names, int namesSize, const SpoutLockPolicy& policy);
+
+		//
+		// Orphan sender removal
+		//
+
+		// Leave the removal of crashed senders to SweepOrphans.
+		// Sender checks and GetSenderCount then don't release names or
+		// open the maps of other senders.
+		void SetDeferredCleanup(bool bDeferred);
+		bool GetDeferredCleanup();
+		// Release registered senders whose info map no longer exists.
+		// Gives up if the sender set lock is not taken within the policy.
+		// Returns the number of senders released.
+		int SweepOrphans(const SpoutLockPolicy& policy);
+		// Check the shared sender set for inconsistencies left by concurrent
+		// registration : duplicate or unsorted names, an active sender that
+		// is not in the set. Returns the number of problems found (logged).
+		int ValidateSenderSet();
 
 		//
 		// Maximum number of senders allowed in the list
@@ -134,12 +245,23 @@ class SPOUT_DLLEXP spoutSenderNames {
 		bool SetSenderInfo (const char* sendername, unsigned int width, unsigned int height, HANDLE dxShareHandle, DWORD dwFormat);
 		// Set sender PartnerID field with "CPU" sharing method and GL/DX compatibility
 		bool SetSenderID(const char *sendername, bool bCPU, bool bGLDX);
+		// Set or clear the bottom-up row order flag (SpoutInfoBottomUp)
+		bool SetSenderRowOrder(const char *sendername, bool bBottomUp);
 		// Generic sender map info read (returned in a shared texture information structure)
 		bool getSharedInfo (const char* sendername, SharedTextureInfo* info);
 		// Generic sender map info write
 		bool setSharedInfo (const char* sendername, SharedTextureInfo* info);
 		// Test for shared info memory map existence
 		bool hasSharedInfo(const char* sendername);
+		// Test that the info map exists and that the process of the sender,
+		// if published, is still running. Doesn't use the info cache.
+		bool senderExists(const char* sendername);
+		// Test that a name is used by a live sender other than the senders
+		// of this object, from the process published in its info map.
+		// Names left by crashed senders can be taken over.
+		bool isSenderNameTaken(const char* sendername);
+		// Close the cached info map of a sender opened by getSharedInfo
+		void releaseSharedInfo(const char* sendername);
 
 		//
 		// Functions to maintain the active sender
@@ -165,6 +287,10 @@ class SPOUT_DLLEXP spoutSenderNames {
 		bool UpdateSender (const char* sendername, unsigned int width, unsigned int height, HANDLE hSharehandle, DWORD dwFormat = 0);
 		// Check details of a sender
 		bool CheckSender  (const char* sendername, unsigned int &width, unsigned int &height, HANDLE &hSharehandle, DWORD &dwFormat);
+		// Check details of a sender without waiting for map locks beyond the policy
+		SpoutCheckResult CheckSender(const char* sendername, const SpoutLockPolicy& policy, unsigned int &width, unsigned int &height, HANDLE &hSharehandle, DWORD &dwFormat);
+		// Check a number of senders with a single read of the sender set
+		void CheckSenders(SpoutSenderQuery* queries, int count, const SpoutLockPolicy& policy);
 		// Find a sender and return details
 		bool FindSender   (char* sendername, unsigned int &width, unsigned int &height, HANDLE &hSharehandle, DWORD &dwFormat);
 		// Get sender in this class
@@ -179,6 +305,16 @@ protected:
 		bool CreateSenderSet();
 		bool GetSenderSet (std::set<std::string>& SenderNames);
 
+		// Sender set generation : bumped on every change of the sender set
+		// so that readers can skip rebuilding the set when it is unchanged
+		DWORD getSenderSetGeneration();
+		void bumpSenderSetGeneration();
+		// Number of extension segments in use (second word of the generation map)
+		int getSenderSetSegments();
+		void setSenderSetSegments(int segments);
+		// Bring m_senderSetCache up to date with the shared sender set
+		SpoutCheckResult updateSenderSetCache(const SpoutLockPolicy& policy);
+
 		// Active sender management
 		bool setActiveSenderName (const char* SenderName);
 		bool getActiveSenderName (char SenderName[SpoutMaxSenderNameLen]);
@@ -187,12 +323,63 @@ protected:
 		// any that shouldn't still be around
 		void cleanSenderSet();
 
+		// Check a sender against the cached sender set
+		void checkCachedSender(SpoutSenderQuery& query, const SpoutLockPolicy& policy);
+
+		// Sender info read with a lock policy
+		SpoutCheckResult readSharedInfo(const char* sendername, SharedTextureInfo* info, const SpoutLockPolicy& policy);
+
+		// Read or write the sender set including the extension segments.
+		// The first map must be locked, pBuf is its buffer.
+		void readSenderSet(const char* pBuf, SpoutSenderNameTable& SenderNames);
+		bool writeSenderSet(const SpoutSenderNameTable& SenderNames, char* pBuf);
+		// Total number of names in the first map and the extension segments
+		int senderSetCapacity();
+		// Names written to the first map before using the segments
+		int senderSetFirstMapLimit();
+		// Buffer of an extension segment (1 to SpoutMaxSenderNameSegments),
+		// created if bCreate is set, NULL if it does not exist
+		char* senderSetSegment(int index, bool bCreate);
+
 		// Functions to manage shared memory map access
 		static void readSenderSetFromBuffer(const char* buffer, std::set<std::string>& SenderNames, int maxSenders);
 		static void	writeBufferFromSenderSet(const std::set<std::string>& SenderNames, char *buffer, int maxSenders);
 
+		// Sender info access using the sequence word in SharedTextureInfo
+		static bool readSharedInfoBuffer(const char* buffer, SharedTextureInfo* info);
+		static void writeSharedInfoBuffer(char* buffer, const SharedTextureInfo* info);
+		// Write the texture fields only (shareHandle, width, height, format)
+		static void writeSharedInfoFields(char* buffer, const SharedTextureInfo* info);
+
+		// Sender process ID in the description, 0 if not published
+		static DWORD getSenderProcessId(const SharedTextureInfo* info);
+		// RegisterSenderName for CreateSender : with bTakeOver, a name that
+		// is already in the set has been checked to be free (left by a
+		// sender that has gone) and is taken over.
+		bool registerSenderName(const char* sendername, bool bTakeOver);
+		// Process published in the info map of a sender, false if there is
+		// no map. The process is 0 for a legacy sender or a busy map.
+		bool readSenderProcessId(const char* sendername, DWORD& processId);
+		static void setSenderProcessId(SharedTextureInfo* info, DWORD processId);
+		static bool isProcessRunning(DWORD processId);
+
 		SpoutSharedMemory	m_senderNames;
 		SpoutSharedMemory	m_activeSender;
+		SpoutSharedMemory	m_senderGeneration; // "SpoutSenderNamesGeneration"
+		std::vector<SpoutSharedMemory*>* m_senderSetSegments; // Extension segments
+		int m_senderSetSlots; // Names that fit in the first map as it was created
+
+		// Sender set being modified by registration and cleanup,
+		// kept to reuse its storage
+		SpoutSenderNameTable* m_senderSetWork;
+
+		// Parsed sender set and the generation it was read at
+		SpoutSenderNameTable* m_senderSetCache;
+		DWORD m_senderSetCacheGeneration;
+		ULONGLONG m_senderSetCacheTime; // GetTickCount64 when the set was parsed
+		bool m_senderSetCacheValid;
+
+		bool m_bDeferredCleanup; // Orphans are left to SweepOrphans
 
 		// This should be a unordered_map of sender names ->SharedMemory
 		// to handle multiple inputs and outputs all going through the
@@ -200,8 +387,23 @@ protected:
 		// Make this a pointer to avoid size differences between compilers
 		// if the .dll is compiled with something different
 		std::unordered_map<std::string, SpoutSharedMemory*>*	m_senders;
+		// Info last written to the map of each sender in m_senders
+		std::unordered_map<std::string, SharedTextureInfo>*	m_senderShadows;
 		int m_MaxSenders; // maximum number of senders via registry
 
+		// Sender info maps of other senders opened by getSharedInfo.
+		// These are kept open so that polling a sender is a lock and a copy
+		// instead of an open/map/close sequence on every call.
+		// The keys are views of the names held by the entries, so that a
+		// lookup with a sender name doesn't allocate.
+		struct SharedInfoCacheEntry {
+			SpoutSharedMemory* map;
+			int reads; // reads since the sender was last checked
+			DWORD processId; // sender process, 0 if not published
+			std::unique_ptr<char[]> name; // storage of the key
+		};
+		std::unordered_map<std::string_view, SharedInfoCacheEntry>* m_infoCache;
+
 };
 
 #endif
@@ -38,6 +38,7 @@
 #include "SpoutSharedMemory.h"
 #include <assert.h>
 #include <string>
+#include <thread>
 
 
 //
@@ -48,6 +49,12 @@
 // Refer to source code for documentation.
 //
 
+//
+// Win32 backend : named file mapping and named mutex
+// See SpoutSharedMemoryPosix.cpp for other platforms
+//
+
+#ifdef _WIN32
 
 SpoutSharedMemory::SpoutSharedMemory()
 {
@@ -57,6 +64,7 @@ SpoutSharedMemory::SpoutSharedMemory()
 	m_pName = NULL;
 	m_size = 0;
 	m_lockCount = 0;
+	m_pStats = NULL;
 }
 
 SpoutSharedMemory::~SpoutSharedMemory()
@@ -207,56 +215,156 @@ void SpoutSharedMemory::Close()
 	}
 
 	m_size = 0;
+	if (m_pStats) {
+		SpoutLockStats::Release(m_pStats);
+		m_pStats = NULL;
+	}
 
 }
 
+bool SpoutSharedMemory::Reopen()
+{
+	if (!m_pName)
+		return false;
+
+	std::string name = m_pName;
+	Close();
+	return Open(name.c_str());
+
+}
+
+
+// Acquire the map mutex, waiting up to msec (0 : single attempt)
+bool SpoutSharedMemory::lockMutex(int msec)
+{
+	DWORD waitResult = WaitForSingleObject(m_hMutex, (DWORD)msec);
+	return waitResult == WAIT_OBJECT_0;
+}
+
+void SpoutSharedMemory::unlockMutex()
+{
+	ReleaseMutex(m_hMutex);
+}
+
+// The view is the size of the map rounded up to the page size
+int SpoutSharedMemory::Capacity()
+{
+	if (!m_pBuffer)
+		return 0;
+
+	MEMORY_BASIC_INFORMATION info;
+	if (VirtualQuery((LPCVOID)m_pBuffer, &info, sizeof(info)) == 0)
+		return m_size;
+
+	return (int)info.RegionSize;
+}
+
+void SpoutSharedMemory::Debug()
+{
+	if (m_pName) {
+		SpoutLogNotice("SpoutSharedMemory::Debug : (%s) m_hMap = [0x%.7X], m_pBuffer = [0x%.7X]", m_pName, LOWORD(m_hMap), PtrToUint(m_pBuffer));
+	}
+	else {
+		SpoutLogNotice("SpoutSharedMemory::Debug : Shared Memory Map is not open\n");
+	}
+
+}
+
+#endif // _WIN32
+
+//
+// Backend independent functions
+//
 
 char* SpoutSharedMemory::Lock()
+{
+	return Lock(SpoutLockPolicy{ SPOUT_LOCK_WAIT, 0, 0, 0 });
+}
+
+// Lock with a mutex acquisition policy (see SpoutLockPolicy)
+char* SpoutSharedMemory::Lock(const SpoutLockPolicy& policy)
 {
 	assert(m_lockCount >= 0);
-	assert(m_hMutex);
 
 	if(m_lockCount < 0) {
 		return NULL;
 	}
 
-	if(!m_hMutex) {
-		return NULL;
-	}
-
+	// The buffer is only set together with the mutex
 	if(!m_pBuffer) {
 		return NULL;
 	}
 
+	// Lock-wait counters (SpoutLockStats.h)
+	bool record = SpoutLockStats::IsEnabled();
+
 	if (m_lockCount > 0) {
-		assert(m_pBuffer);
 		m_lockCount++;
+		if (record) Stats()->RecordReentrant();
 		return m_pBuffer;
 	}
 
-	DWORD waitResult = WaitForSingleObject(m_hMutex, 67);
-	if (waitResult != WAIT_OBJECT_0) {
+	uint64_t start = record ? SpoutLockStats::Microseconds() : 0;
+	bool locked = false;
+
+	switch (policy.mode) {
+
+		case SPOUT_LOCK_TRY:
+			locked = lockMutex(0);
+			break;
+
+		case SPOUT_LOCK_SPIN:
+			locked = lockMutex(0);
+			for (int i = 0; !locked && i < policy.spinCount; i++) {
+				std::this_thread::yield();
+				locked = lockMutex(0);
+			}
+			if (!locked && policy.waitTime > 0)
+				locked = lockMutex(policy.waitTime);
+			break;
+
+		case SPOUT_LOCK_DEADLINE: {
+			uint64_t deadline = SpoutLockStats::Microseconds() + (uint64_t)policy.budget;
+			locked = lockMutex(0);
+			while (!locked && SpoutLockStats::Microseconds() < deadline) {
+				std::this_thread::yield();
+				locked = lockMutex(0);
+			}
+			break;
+		}
+
+		default:
+			locked = lockMutex(SPOUT_LOCK_TIMEOUT);
+			break;
+	}
+
+	if (!locked) {
+		if (record) Stats()->RecordTimeout(SpoutLockStats::Microseconds() - start);
 		return NULL;
 	}
 
+	if (record) Stats()->RecordAcquisition(SpoutLockStats::Microseconds() - start);
+
 	m_lockCount++;
 
-	assert(m_pBuffer);
 	return m_pBuffer;
 }
 
 void SpoutSharedMemory::Unlock()
 {
-	assert(m_hMutex);
-
 	m_lockCount--;
 	assert(m_lockCount >= 0);
 
 	if (m_lockCount == 0) {
-		ReleaseMutex(m_hMutex);
+		unlockMutex();
 	}
 }
 
+char* SpoutSharedMemory::Buffer()
+{
+	return m_pBuffer;
+}
+
 const char* SpoutSharedMemory::Name()
 {
 	return m_pName;
@@ -266,14 +374,3 @@ int SpoutSharedMemory::Size()
 {
 	return m_size;
 }
-
-void SpoutSharedMemory::Debug()
-{
-	if (m_pName) {
-		SpoutLogNotice("SpoutSharedMemory::Debug : (%s) m_hMap = [0x%.7X], m_pBuffer = [0x%.7X]", m_pName, LOWORD(m_hMap), PtrToUint(m_pBuffer));
-	}
-	else {
-		SpoutLogNotice("SpoutSharedMemory::Debug : Shared Memory Map is not open\n");
-	}
-
-}
@@ -35,12 +35,43 @@
 #ifndef __SpoutSharedMemory_ // standard way as well
 #define __SpoutSharedMemory_
 
+#include "SpoutLockStats.h"
+
+#ifdef _WIN32
 #include "SpoutCommon.h"
 #include <windowsx.h>
 #include <d3d9.h>
 #include <wingdi.h>
 
 using namespace spoututils;
+#else
+// POSIX backend (SpoutSharedMemoryPosix.cpp)
+// shm_open/mmap segment with a process-shared robust mutex in its header
+#include <stddef.h>
+#define SPOUT_DLLEXP
+struct SpoutSharedMemoryHeader;
+#endif
+
+// Default wait for the map mutex (msec)
+#define SPOUT_LOCK_TIMEOUT 67
+
+// Mutex acquisition mode for SpoutSharedMemory::Lock
+enum SpoutLockMode
+{
+	SPOUT_LOCK_WAIT = 0, // Wait up to SPOUT_LOCK_TIMEOUT (default)
+	SPOUT_LOCK_TRY, // Single attempt, never blocks
+	SPOUT_LOCK_SPIN, // Retry spinCount times, then wait up to waitTime
+	SPOUT_LOCK_DEADLINE, // Retry until budget has elapsed
+};
+
+// Mutex acquisition policy
+struct SpoutLockPolicy
+{
+	SpoutLockMode mode;
+	int spinCount; // SPOUT_LOCK_SPIN : attempts before waiting
+	int waitTime; // SPOUT_LOCK_SPIN : wait after spinning (msec)
+	int budget; // SPOUT_LOCK_DEADLINE : time limit (usec)
+};
 
 // Result of memory segment creation
 enum SpoutCreateResult
@@ -67,29 +98,62 @@ public:
 	// Close a map
 	void Close();
 
+	// Close the map and open it again. Returns false if the map is gone,
+	// which is when no other object has kept it open.
+	bool Reopen();
+
 	// Lock an open map and return the buffer
 	char* Lock();
 
+	// Lock an open map with an acquisition policy.
+	// Returns NULL if the mutex could not be taken within the policy.
+	char* Lock(const SpoutLockPolicy& policy);
+
 	// Unlock a map
 	void Unlock();
 
+	// Buffer of an open map without taking the lock.
+	// Only for readers that detect torn reads by other means.
+	char* Buffer();
+
 	// Name of an existing map
 	const char* Name();
 	
 	// Size of an existing map
 	int Size();
 
+	// Usable size of an open map, also for a map created by another
+	// process with a different size (rounded up to pages on Windows)
+	int Capacity();
+
 	// Print map information for debugging
 	void Debug();
 
 private:
 
 	char*  m_pBuffer; // Buffer pointer
+#ifdef _WIN32
 	HANDLE m_hMap; // Map handle
 	HANDLE m_hMutex; // Mutex for map access
+#else
+	int m_fd; // Shared memory object descriptor
+	size_t m_mapSize; // Mapped length including the header
+	SpoutSharedMemoryHeader* m_pHeader; // Mutex and attach count
+#endif
 	int m_lockCount; // Map access lock count
 	const char*	m_pName; // Map name
 	int m_size; // Map size
+	SpoutLockStats* m_pStats; // Lock counters for this map name, released on Close
+
+	// Backend mutex access (msec 0 : single attempt)
+	bool lockMutex(int msec);
+	void unlockMutex();
+
+	// Counters of this map, looked up on first use
+	SpoutLockStats* Stats() {
+		if (!m_pStats) m_pStats = SpoutLockStats::Acquire(m_pName);
+		return m_pStats;
+	}
 
 };
 
@@ -0,0 +1,477 @@
+/**
+
+	SpoutSharedMemoryPosix.cpp
+
+	POSIX backend for SpoutSharedMemory
+
+	The Win32 implementation in SpoutSharedMemory.cpp uses a named file
+	mapping and a separate named mutex "<name>_mutex". Here a shm_open
+	segment carries both : a small header holding a process-shared robust
+	mutex and an attach count, followed by the map buffer.
+
+	The attach count has a mutex of its own, only held while it's updated.
+	Open and Close never wait for the map mutex, as with the Win32 version,
+	so a receiver that re-opens a map doesn't block behind a writer
+	holding it, whatever lock policy it uses.
+
+	Only the backend functions are here. Lock, Unlock and the accessors
+	are shared with the Win32 version in SpoutSharedMemory.cpp.
+
+	Semantics kept from the Win32 version :
+	- Create returns SPOUT_ALREADY_EXISTS when the segment exists
+	  and SPOUT_ALREADY_CREATED when called twice on the same object
+	- Open attaches to an existing segment only and reports a size of 0
+	- Lock is re-entrant through the lock count and waits up to 67 msec
+	  (the robust mutex itself is not recursive, so unlike a named Win32
+	  mutex two objects for the same map in one thread do not nest)
+	- The segment is removed when the last attached object is closed
+
+	A process that crashes while holding the mutex does not block others,
+	the next locker recovers it as with an abandoned Win32 mutex.
+	Attachments are counted per process in the header as well, so those
+	of a crashed process are released when the mutex is recovered and
+	whenever another object attaches or detaches. The segment is then
+	removed with the last attachment of a live process, as Windows does
+	when the handles of a crashed process are closed.
+
+	Object names can be given a prefix through the environment variable
+	SPOUT_SHM_NAMESPACE, so that test runs don't see each other or the
+	applications running on the same machine.
+
+*/
+
+#ifndef _WIN32 // See SpoutSharedMemory.cpp for the Win32 backend
+
+#include "SpoutSharedMemory.h"
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <string>
+
+// Number of processes whose attachments are tracked in a segment header.
+// Attachments of further processes are counted but can't be recovered.
+#define SpoutSharedMemoryProcesses 64
+
+// Attachments of a process
+struct SpoutSharedMemoryProcess {
+	pid_t pid; // 0 : free entry
+	int count;
+};
+
+// Segment header placed in front of the map buffer
+struct SpoutSharedMemoryHeader {
+	pthread_mutex_t mutex; // Mutex for map access
+	pthread_mutex_t attachMutex; // Mutex for the attachment counts
+	int ready; // Set when the creator has initialized the mutexes
+	int attachCount; // Number of objects attached to the segment
+	int size; // Size requested by the creator
+	int untracked; // Attachments of processes not in the table
+	SpoutSharedMemoryProcess processes[SpoutSharedMemoryProcesses];
+};
+
+namespace {
+
+// Map buffer offset, keeping the buffer cache line aligned
+const size_t HeaderSize = (sizeof(SpoutSharedMemoryHeader) + 63) & ~(size_t)63;
+
+// Wait for the creator to set the segment up, same as for Lock
+const int SetupTimeout = SPOUT_LOCK_TIMEOUT; // msec
+
+// Shared memory object name : leading slash and no other slashes
+std::string ObjectName(const char* name)
+{
+	std::string path = "/";
+	if (const char* prefix = getenv("SPOUT_SHM_NAMESPACE")) path += prefix;
+	path += name;
+	for (size_t i = 1; i < path.size(); i++)
+		if (path[i] == '/') path[i] = '_';
+	return path;
+}
+
+// Absolute CLOCK_REALTIME deadline for pthread_mutex_timedlock
+timespec Deadline(int msec)
+{
+	timespec ts;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += msec / 1000;
+	ts.tv_nsec += (long)(msec % 1000) * 1000000;
+	if (ts.tv_nsec >= 1000000000) {
+		ts.tv_sec++;
+		ts.tv_nsec -= 1000000000;
+	}
+	return ts;
+}
+
+// Check if a process still exists
+bool IsAlive(pid_t pid)
+{
+	return kill(pid, 0) == 0 || errno == EPERM;
+}
+
+// Count an attachment of this process (header locked)
+void Attach(SpoutSharedMemoryHeader* header)
+{
+	pid_t self = getpid();
+	SpoutSharedMemoryProcess* entry = NULL;
+	for (SpoutSharedMemoryProcess& p : header->processes) {
+		if (p.pid == self) {
+			entry = &p;
+			break;
+		}
+		if (p.pid == 0 && !entry)
+			entry = &p;
+	}
+	if (entry) {
+		entry->pid = self;
+		entry->count++;
+	}
+	else {
+		header->untracked++;
+	}
+	header->attachCount++;
+}
+
+// Remove an attachment of this process (header locked)
+void Detach(SpoutSharedMemoryHeader* header)
+{
+	pid_t self = getpid();
+	for (SpoutSharedMemoryProcess& p : header->processes) {
+		if (p.pid == self) {
+			if (--p.count == 0) p.pid = 0;
+			header->attachCount--;
+			return;
+		}
+	}
+	if (header->untracked > 0) header->untracked--;
+	header->attachCount--;
+}
+
+// Release the attachments of processes that have exited (header locked)
+void ReleaseDeadProcesses(SpoutSharedMemoryHeader* header)
+{
+	pid_t self = getpid();
+	for (SpoutSharedMemoryProcess& p : header->processes) {
+		if (p.pid == 0 || p.pid == self || IsAlive(p.pid)) continue;
+		header->attachCount -= p.count;
+		p.pid = 0;
+		p.count = 0;
+	}
+}
+
+// Lock the attachment counts. This mutex is only held for the updates of
+// the counts, so it's waited for without a timeout.
+void LockAttach(SpoutSharedMemoryHeader* header)
+{
+	if (pthread_mutex_lock(&header->attachMutex) == EOWNERDEAD) {
+		pthread_mutex_consistent(&header->attachMutex);
+		ReleaseDeadProcesses(header);
+	}
+}
+
+void UnlockAttach(SpoutSharedMemoryHeader* header)
+{
+	pthread_mutex_unlock(&header->attachMutex);
+}
+
+// Take over the map mutex of an owner that has died
+void Recover(SpoutSharedMemoryHeader* header)
+{
+	pthread_mutex_consistent(&header->mutex);
+	LockAttach(header);
+	ReleaseDeadProcesses(header);
+	UnlockAttach(header);
+}
+
+// Lock the map mutex, recovering it from a crashed owner
+bool LockHeader(SpoutSharedMemoryHeader* header, int msec)
+{
+	timespec deadline = Deadline(msec);
+	int res = pthread_mutex_timedlock(&header->mutex, &deadline);
+	if (res == EOWNERDEAD) {
+		Recover(header);
+		res = 0;
+	}
+	return res == 0;
+}
+
+// Wait until a condition set by another process holds, for up to msec
+template <typename Predicate>
+bool WaitFor(Predicate pred, int msec)
+{
+	for (int i = 0; i < msec; i++) {
+		if (pred()) return true;
+		usleep(1000);
+	}
+	return pred();
+}
+
+} // anonymous namespace
+
+SpoutSharedMemory::SpoutSharedMemory()
+{
+	m_pBuffer = NULL;
+	m_fd = -1;
+	m_mapSize = 0;
+	m_pHeader = NULL;
+	m_pName = NULL;
+	m_size = 0;
+	m_lockCount = 0;
+	m_pStats = NULL;
+}
+
+SpoutSharedMemory::~SpoutSharedMemory()
+{
+	Close();
+}
+
+// Create a new memory segment, or attach to an existing one
+SpoutCreateResult SpoutSharedMemory::Create(const char* name, int size)
+{
+	assert(name);
+	assert(size);
+
+	if (m_fd >= 0) {
+		assert(strcmp(name, m_pName) == 0);
+		assert(m_pBuffer && m_pHeader);
+		return SPOUT_ALREADY_CREATED;
+	}
+
+	std::string path = ObjectName(name);
+
+	// A segment left by crashed processes is removed by Open,
+	// in which case the creation is tried again
+	for (int attempt = 0; attempt < 2; attempt++) {
+		m_fd = shm_open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+		if (m_fd >= 0 || errno != EEXIST)
+			break;
+		// Attach to the existing segment.
+		// The size of the map will be the same as when it was created.
+		if (Open(name)) {
+			m_size = size;
+			return SPOUT_ALREADY_EXISTS;
+		}
+	}
+
+	if (m_fd < 0)
+		return SPOUT_CREATE_FAILED;
+
+	// A new segment is zero filled by ftruncate
+	size_t length = HeaderSize + (size_t)size;
+	if (ftruncate(m_fd, (off_t)length) != 0) {
+		shm_unlink(path.c_str());
+		Close();
+		return SPOUT_CREATE_FAILED;
+	}
+
+	void* map = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+	if (map == MAP_FAILED) {
+		shm_unlink(path.c_str());
+		Close();
+		return SPOUT_CREATE_FAILED;
+	}
+
+	m_mapSize = length;
+	m_pHeader = (SpoutSharedMemoryHeader*)map;
+	m_pBuffer = (char*)map + HeaderSize;
+
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init(&attr);
+	pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+	pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+	pthread_mutex_init(&m_pHeader->mutex, &attr);
+	pthread_mutex_init(&m_pHeader->attachMutex, &attr);
+	pthread_mutexattr_destroy(&attr);
+
+	Attach(m_pHeader);
+	m_pHeader->size = size;
+	__atomic_store_n(&m_pHeader->ready, 1, __ATOMIC_RELEASE);
+
+	// Set the name and size
+	m_pName = strdup(name);
+	m_size = size;
+
+	return SPOUT_CREATE_SUCCESS;
+}
+
+bool SpoutSharedMemory::Open(const char* name)
+{
+	// Don't call open twice on the same object without a Close()
+	assert(name);
+
+	if (m_fd >= 0) {
+		assert(strcmp(name, m_pName) == 0);
+		assert(m_pBuffer && m_pHeader);
+		return true;
+	}
+
+	m_fd = shm_open(ObjectName(name).c_str(), O_RDWR, 0);
+	if (m_fd < 0) {
+		return false;
+	}
+
+	// The creator may not have sized the segment yet
+	struct stat st;
+	bool sized = WaitFor([&] {
+		return fstat(m_fd, &st) == 0 && (size_t)st.st_size > HeaderSize;
+	}, SetupTimeout);
+
+	if (!sized) {
+		Close();
+		return false;
+	}
+
+	size_t length = (size_t)st.st_size;
+	void* map = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+	if (map == MAP_FAILED) {
+		Close();
+		return false;
+	}
+
+	SpoutSharedMemoryHeader* header = (SpoutSharedMemoryHeader*)map;
+
+	// The creator may not have initialized the mutexes yet
+	bool ready = WaitFor([&] {
+		return __atomic_load_n(&header->ready, __ATOMIC_ACQUIRE) != 0;
+	}, SetupTimeout);
+
+	if (!ready) {
+		munmap(map, length);
+		Close();
+		return false;
+	}
+
+	LockAttach(header);
+
+	// The last object has detached and unlinked the segment,
+	// or only crashed processes were attached, as with a Win32 map
+	// whose handles are closed when the process ends
+	int attached = header->attachCount;
+	ReleaseDeadProcesses(header);
+	if (header->attachCount <= 0) {
+		if (attached > 0) shm_unlink(ObjectName(name).c_str());
+		UnlockAttach(header);
+		munmap(map, length);
+		Close();
+		return false;
+	}
+
+	Attach(header);
+	UnlockAttach(header);
+
+	m_mapSize = length;
+	m_pHeader = header;
+	m_pBuffer = (char*)map + HeaderSize;
+
+	m_pName = strdup(name);
+	// As with the Win32 version, only the creator knows the size
+	m_size = 0;
+
+	return true;
+}
+
+void SpoutSharedMemory::Close()
+{
+	if (m_pHeader) {
+		// Release the lock if this object still holds it
+		if (m_lockCount > 0) {
+			m_lockCount = 0;
+			pthread_mutex_unlock(&m_pHeader->mutex);
+		}
+		// Detach, removing the segment name with the last attachment
+		LockAttach(m_pHeader);
+		Detach(m_pHeader);
+		ReleaseDeadProcesses(m_pHeader);
+		if (m_pHeader->attachCount <= 0 && m_pName)
+			shm_unlink(ObjectName(m_pName).c_str());
+		UnlockAttach(m_pHeader);
+		munmap(m_pHeader, m_mapSize);
+	}
+
+	m_pBuffer = NULL;
+	m_pHeader = NULL;
+	m_mapSize = 0;
+
+	if (m_fd >= 0) {
+		close(m_fd);
+		m_fd = -1;
+	}
+
+	if (m_pName) {
+		free((void*)m_pName);
+		m_pName = NULL;
+	}
+
+	m_size = 0;
+	if (m_pStats) {
+		SpoutLockStats::Release(m_pStats);
+		m_pStats = NULL;
+	}
+}
+
+// Same result as a Close and Open without remapping the segment : it's gone
+// when no other object is attached to it. Close unlinks it in that case.
+bool SpoutSharedMemory::Reopen()
+{
+	if (!m_pHeader) {
+		return false;
+	}
+
+	LockAttach(m_pHeader);
+	ReleaseDeadProcesses(m_pHeader);
+	bool shared = m_pHeader->attachCount > 1;
+	UnlockAttach(m_pHeader);
+
+	if (!shared) Close();
+	return shared;
+}
+
+// Acquire the map mutex, waiting up to msec (0 : single attempt)
+bool SpoutSharedMemory::lockMutex(int msec)
+{
+	if (!m_pHeader) {
+		return false;
+	}
+
+	if (msec > 0) {
+		return LockHeader(m_pHeader, msec);
+	}
+
+	int res = pthread_mutex_trylock(&m_pHeader->mutex);
+	if (res == EOWNERDEAD) {
+		Recover(m_pHeader);
+		res = 0;
+	}
+	return res == 0;
+}
+
+void SpoutSharedMemory::unlockMutex()
+{
+	pthread_mutex_unlock(&m_pHeader->mutex);
+}
+
+// The segment is sized by its creator
+int SpoutSharedMemory::Capacity()
+{
+	return m_pHeader ? (int)(m_mapSize - HeaderSize) : 0;
+}
+
+void SpoutSharedMemory::Debug()
+{
+	if (m_pName) {
+		printf("SpoutSharedMemory::Debug : (%s) m_fd = [%d], m_pBuffer = [%p]\n", m_pName, m_fd, (void*)m_pBuffer);
+	}
+	else {
+		printf("SpoutSharedMemory::Debug : Shared Memory Map is not open\n");
+	}
+}
+
+#endif // _WIN32
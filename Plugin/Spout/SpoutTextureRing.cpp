@@ -0,0 +1,135 @@
+/*
+
+	SpoutTextureRing.cpp
+
+	Multi-buffered shared textures of a sender
+
+*/
+
+#include "SpoutTextureRing.h"
+
+// The counters are accessed as atomics in place in the shared memory.
+static_assert(sizeof(std::atomic<int32_t>) == sizeof(int32_t),
+	"std::atomic<int32_t> must have the size of int32_t");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+	"std::atomic<uint32_t> must have the size of uint32_t");
+
+SpoutTextureRing::SpoutTextureRing(void* buffer)
+	: m_pInfo((SpoutRingInfo*)buffer)
+{
+}
+
+void SpoutTextureRing::Attach(void* buffer)
+{
+	m_pInfo = (SpoutRingInfo*)buffer;
+}
+
+bool SpoutTextureRing::IsValid() const
+{
+	return m_pInfo && m_pInfo->magic == SpoutRingMagic
+		&& m_pInfo->slotCount > 0 && m_pInfo->slotCount <= SpoutRingMaxSlots;
+}
+
+int SpoutTextureRing::SlotCount() const
+{
+	return IsValid() ? (int)m_pInfo->slotCount : 0;
+}
+
+uint32_t SpoutTextureRing::Handle(int slot) const
+{
+	return (slot >= 0 && slot < SlotCount()) ? m_pInfo->handles[slot] : 0;
+}
+
+void SpoutTextureRing::Initialize(int slotCount, const uint32_t* handles)
+{
+	if (!m_pInfo) return;
+	if (slotCount > SpoutRingMaxSlots) slotCount = SpoutRingMaxSlots;
+
+	// Invalidate the ring while the slots are replaced
+	uint32_t epoch = IsValid() ? m_pInfo->epoch + 1 : 1;
+	m_pInfo->magic = 0;
+	Latest().store(-1);
+
+	for (int i = 0; i < SpoutRingMaxSlots; i++) {
+		Readers(i).store(0);
+		m_pInfo->handles[i] = i < slotCount ? handles[i] : 0;
+	}
+
+	m_pInfo->slotCount = (uint32_t)slotCount;
+	m_pInfo->frame = 0;
+	Epoch().store(epoch);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	m_pInfo->magic = SpoutRingMagic;
+}
+
+int SpoutTextureRing::BeginWrite(uint32_t busy) const
+{
+	int count = SlotCount();
+	if (count == 0) return -1;
+
+	// Start from the slot after the latest one, so that the slots are used
+	// in turn and a released slot gets time to drain on the GPU.
+	int latest = Latest().load();
+	for (int i = 1; i <= count; i++) {
+		int slot = (latest + i + count) % count;
+		if (slot == latest || (busy & (1u << slot))) continue;
+		if (Readers(slot).load() == 0) return slot;
+	}
+
+	return -1;
+}
+
+void SpoutTextureRing::EndWrite(int slot)
+{
+	if (slot < 0 || slot >= SlotCount()) return;
+	Latest().store(slot);
+	m_pInfo->frame++;
+}
+
+int SpoutTextureRing::AcquireLatest(uint32_t& epoch)
+{
+	if (!IsValid()) return -1;
+
+	for (;;) {
+		epoch = Epoch().load();
+		int slot = Latest().load();
+		if (slot < 0 || slot >= (int)m_pInfo->slotCount) return -1;
+
+		Readers(slot).fetch_add(1);
+
+		// The writer may have moved on (or set the ring up again) before
+		// the count was raised.
+		if (Latest().load() == slot && Epoch().load() == epoch) return slot;
+
+		// The count may have been reset by Initialize in the meantime
+		DecrementReaders(slot);
+	}
+}
+
+void SpoutTextureRing::Release(int slot, uint32_t epoch)
+{
+	if (slot < 0 || slot >= SlotCount() || Epoch().load() != epoch) return;
+	DecrementReaders(slot);
+}
+
+// Never below zero, which would block the slot for the writer
+void SpoutTextureRing::DecrementReaders(int slot)
+{
+	int32_t count = Readers(slot).load();
+	while (count > 0 && !Readers(slot).compare_exchange_weak(count, count - 1)) {}
+}
+
+std::atomic<int32_t>& SpoutTextureRing::Latest() const
+{
+	return *(std::atomic<int32_t>*)&m_pInfo->latest;
+}
+
+std::atomic<uint32_t>& SpoutTextureRing::Epoch() const
+{
+	return *(std::atomic<uint32_t>*)&m_pInfo->epoch;
+}
+
+std::atomic<int32_t>& SpoutTextureRing::Readers(int slot) const
+{
+	return *(std::atomic<int32_t>*)&m_pInfo->readers[slot];
+}
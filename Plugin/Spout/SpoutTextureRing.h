@@ -0,0 +1,107 @@
+/*
+
+	SpoutTextureRing.h
+
+	Multi-buffered shared textures of a sender
+
+	A sender may share a ring of textures instead of a single one, so that
+	it never writes a texture that a receiver is reading. The ring is
+	described in a shared memory map named "<sender name>_ring", next to
+	the usual sender info map. The info map holds the share handle of the
+	latest slot, so receivers that don't know about the ring keep working
+	(they see a new handle on every frame).
+
+	Protocol
+	- The writer picks a slot that is neither the latest one, nor held by
+	  any reader, nor still being written by an earlier frame (the busy
+	  mask of BeginWrite), and copies into it. It publishes the slot as the
+	  latest one once the GPU has finished the copy, which it tracks with
+	  a fence or an event query.
+	- A reader increments the reader count of the latest slot, then checks
+	  that it's still the latest one. If not, it backs off and retries. The
+	  slot is held until the reader releases it.
+	Both sides use sequentially consistent atomics, so either the writer
+	sees the reader count or the reader sees the newer latest index. A slot
+	is never handed to a reader while it's being written and never written
+	while a reader holds it.
+
+	The reader count only covers the CPU side. The GPU may still read a
+	released texture for a few frames, so three or more slots are used :
+	the latest one, one being written and one to drain.
+
+	The writer sets the ring up again when the textures are replaced (on a
+	resize). This increments the epoch, and releases from readers of the
+	previous epoch are ignored. A reader that crashes while holding a slot
+	keeps it busy until then.
+
+	This only depends on the map contents, so the protocol can be tested
+	with plain memory and threads.
+
+*/
+#pragma once
+
+#ifndef __SpoutTextureRing__
+#define __SpoutTextureRing__
+
+#include <atomic>
+#include <stdint.h>
+
+#define SpoutRingMaxSlots 8
+#define SpoutRingMagic 0x53524E47 // "SRNG"
+
+// Layout of the ring map
+struct SpoutRingInfo {
+	uint32_t magic; // SpoutRingMagic once initialized
+	uint32_t slotCount;
+	int32_t latest; // Latest complete slot (-1 : none yet)
+	uint32_t frame; // Incremented on every publish
+	uint32_t epoch; // Incremented on every Initialize
+	int32_t readers[SpoutRingMaxSlots]; // Reader count of each slot
+	uint32_t handles[SpoutRingMaxSlots]; // Share handle of each slot
+};
+
+class SpoutTextureRing {
+
+public:
+
+	// Attach to a ring map buffer of sizeof(SpoutRingInfo) bytes
+	explicit SpoutTextureRing(void* buffer = nullptr);
+
+	void Attach(void* buffer);
+
+	// Check that the buffer holds an initialized ring
+	bool IsValid() const;
+
+	int SlotCount() const;
+	uint32_t Handle(int slot) const;
+
+	// Writer : Set up the ring with the share handles of the textures
+	void Initialize(int slotCount, const uint32_t* handles);
+
+	// Writer : Slot to write next (-1 if all the slots are busy)
+	// Bit n of "busy" marks slot n as still in use by the writer.
+	int BeginWrite(uint32_t busy = 0) const;
+
+	// Writer : Publish a written slot as the latest one (once the GPU has
+	// finished writing it)
+	void EndWrite(int slot);
+
+	// Reader : Hold the latest slot (-1 if there is none yet)
+	int AcquireLatest(uint32_t& epoch);
+
+	// Reader : Release a slot held by AcquireLatest
+	void Release(int slot, uint32_t epoch);
+
+private:
+
+	SpoutRingInfo* m_pInfo;
+
+	std::atomic<int32_t>& Latest() const;
+	std::atomic<uint32_t>& Epoch() const;
+	std::atomic<int32_t>& Readers(int slot) const;
+
+	void DecrementReaders(int slot);
+
+};
+
+#endif
@@ -71,6 +71,9 @@
 				   Bring the main window to the top again
 		07.05.21 - Remove noisy warning from ReadPathFromRegistry
 		09.06.21 - Update Version to "2.007.002"
+		18.10.26 - _doLog : return before formatting if there is no console or file output
+				   Console output prints the formatted log instead of re-using the va_list
+				 - Registry functions return false on other platforms (SpoutPosix.h)
 
 */
 #include "SpoutUtils.h"
@@ -416,6 +419,7 @@ namespace spoututils {
 	//
 	// Registry utilities
 	//
+#ifdef _WIN32
 
 	//
 	// New registry functions for 2.007 including hKey and changed argument order
@@ -630,6 +634,17 @@ namespace spoututils {
 		return false;
 
 	}
+#else
+	// No registry on other platforms : values are never found and not saved
+	bool ReadDwordFromRegistry(HKEY, const char*, const char*, DWORD*) { return false; }
+	bool WriteDwordToRegistry(HKEY, const char*, const char*, DWORD) { return false; }
+	bool ReadPathFromRegistry(HKEY, const char*, const char*, char*) { return false; }
+	bool WritePathToRegistry(HKEY, const char*, const char*, const char*) { return false; }
+	bool WriteBinaryToRegistry(HKEY, const char*, const char*, const unsigned char*, DWORD) { return false; }
+	bool RemovePathFromRegistry(HKEY, const char*, const char*) { return false; }
+	bool RemoveSubKey(HKEY, const char*) { return false; }
+	bool FindSubKey(HKEY, const char*) { return false; }
+#endif // _WIN32
 
 #ifndef MINI_SPOUTUTILS
 	// Timing utility functions
@@ -668,6 +683,11 @@ namespace spoututils {
 		if (!bDoLogs)
 			return;
 
+		// Return if there is nowhere to log to, so that logs in frequently
+		// called functions cost nothing when logging is not enabled
+		if (!(bEnableLog && bConsole) && !(bEnableLogFile && !logPath.empty()))
+			return;
+
 		if (level != SPOUT_LOG_SILENT
 			&& CurrentLogLevel != SPOUT_LOG_SILENT
 			&& level >= CurrentLogLevel
@@ -694,8 +714,8 @@ namespace spoututils {
 					fprintf(out, "[%s] ", _levelName(level).c_str());
 				}
 
-				vfprintf(out, format, args);
-				fprintf(out, "\n");
+				// args has been used by vsprintf_s
+				fprintf(out, "%s\n", currentLog);
 
 			}
 
@@ -33,17 +33,23 @@
 #ifndef __spoutUtils__ // standard way as well
 #define __spoutUtils__
 
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include "SpoutPosix.h" // Win32 subset for the POSIX build of the registry
+#endif
 #include <stdio.h> // for console
 #include <iostream> // std::cout, std::end
 #include <fstream> // for log file
 #include <time.h> // for time and date
-#include <io.h> // for _access
 #include <vector>
 #include <string>
+#ifdef _WIN32
+#include <io.h> // for _access
 #include <shellapi.h> // for shellexecute
 #include <shlwapi.h> // for path functions
 #include <shlobj.h> // to find the AppData folder
+#endif
 
 //
 // C++11 timer is only available for MS Visual Studio 2015 and above.
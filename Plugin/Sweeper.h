@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Common.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace KlakSpout {
+
+// Background sweeper that removes crashed senders from the Spout sender list
+//
+// The render thread paths leave orphan removal to this thread (see
+// spoutSenderNames::SetDeferredCleanup), so they never open the maps of other
+// senders just to clean up the list. The sweeper uses its own spoutSenderNames
+// instance and doesn't wait for the sender set lock beyond a short budget.
+class OrphanSweeper final
+{
+public:
+
+    OrphanSweeper() : _thread(&OrphanSweeper::run, this) {}
+
+    ~OrphanSweeper()
+    {
+        {
+            std::lock_guard<std::mutex> guard(_stopLock);
+            _stop = true;
+        }
+        _stopSignal.notify_one();
+        _thread.join();
+    }
+
+private:
+
+    static constexpr auto Interval = std::chrono::seconds(1);
+
+    // Lock policy for the sender set (1 msec budget)
+    static constexpr SpoutLockPolicy SweepPolicy
+      = { SPOUT_LOCK_DEADLINE, 0, 0, 1000 };
+
+    std::mutex _stopLock;
+    std::condition_variable _stopSignal;
+    bool _stop = false;
+
+    std::thread _thread; // Started last in the initializer list
+
+    void run()
+    {
+        SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_LOWEST);
+
+        spoutSenderNames spout;
+
+        std::unique_lock<std::mutex> lock(_stopLock);
+
+        while (!_stopSignal.wait_for(lock, Interval, [this]{ return _stop; }))
+            spout.SweepOrphans(SweepPolicy);
+    }
+};
+
+// Singleton instance
+inline std::unique_ptr<OrphanSweeper> _sweeper;
+
+} // namespace KlakSpout
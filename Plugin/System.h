@@ -15,6 +15,7 @@ public:
 
     void shutdown()
     {
+        _flushPending = false;
         _d3d11on12 = nullptr;
         _d3d11_device = nullptr;
         _d3d11_context = nullptr;
@@ -25,9 +26,14 @@ public:
         return _unity->Get<IUnityGraphics>();
     }
 
+    IUnityGraphicsD3D12v6* getD3D12Interface() const
+    {
+        return _unity->Get<IUnityGraphicsD3D12v6>();
+    }
+
     WRL::ComPtr<ID3D12Device> getD3D12Device() const
     {
-        return _unity->Get<IUnityGraphicsD3D12v6>()->GetDevice();
+        return getD3D12Interface()->GetDevice();
     }
 
     WRL::ComPtr<ID3D11On12Device> getD3D11On12Device()
@@ -67,9 +73,37 @@ public:
         }
     }
 
+    // Coalesced D3D11On12 flush
+    // Senders only record their copies, which are submitted with a single
+    // flush at the beginning of the next frame (event_flushSenders), so the
+    // frames are one frame late. This is only used by the D3D11On12 fallback
+    // of the D3D12 sender path; the native path submits at every update.
+    void requestFlush() { _flushPending = true; }
+
+    void flush()
+    {
+        senderStats.frames++;
+        if (!_flushPending || !_d3d11_context) return;
+        _d3d11_context->Flush();
+        _flushPending = false;
+        senderStats.flushes++;
+    }
+
+    // Sender counters (cumulative, render thread only)
+    struct SenderStats
+    {
+        uint32_t frames;        // Flush events
+        uint32_t wrapCreations; // CreateWrappedResource calls
+        uint32_t flushes;       // D3D11On12 flushes
+        uint32_t submissions;   // D3D12 copy queue submissions (per update)
+    };
+
+    SenderStats senderStats = {};
+
 private:
 
     IUnityInterfaces* _unity;
+    bool _flushPending = false;
 
 public:
 
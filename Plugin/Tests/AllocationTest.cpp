@@ -0,0 +1,135 @@
+// Heap allocations of the sender set and sender info paths after warm-up
+// (SpoutSenderNameTable is used in place of std::set on these paths, and
+// the info cache is looked up by name without a std::string)
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+#include <atomic>
+#include <new>
+
+namespace {
+
+std::atomic<uint64_t> allocations;
+
+uint64_t Allocations()
+{
+    return allocations.load(std::memory_order_relaxed);
+}
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+namespace {
+
+// Allocations of a register and release cycle of one name
+// with a number of other senders in the set
+uint64_t CycleAllocations(spoutSenderNames& names, int senders)
+{
+    HANDLE handle = LongToHandle(1);
+    char name[32];
+    for (int i = 0; i < senders; i++) {
+        snprintf(name, sizeof(name), "Sender%03d", i);
+        names.CreateSender(name, 64, 64, handle);
+    }
+
+    for (int i = 0; i < 4; i++) {
+        names.RegisterSenderName("Cycle");
+        names.ReleaseSenderName("Cycle");
+    }
+
+    uint64_t before = Allocations();
+    for (int i = 0; i < 100; i++) {
+        names.RegisterSenderName("Cycle");
+        names.ReleaseSenderName("Cycle");
+    }
+    return Allocations() - before;
+}
+
+// Allocations of the receiver paths (find, enumerate, check with and
+// without the info stamp, snapshot) with 32 senders named from a format
+void ReceiverAllocations(const char* format)
+{
+    const int count = 32;
+    spoutSenderNames sender, receiver;
+    HANDLE handle = LongToHandle(1);
+
+    char names[count][64];
+    for (int i = 0; i < count; i++) {
+        snprintf(names[i], sizeof(names[i]), format, i);
+        CHECK(sender.CreateSender(names[i], 64, 64, handle));
+    }
+
+    SpoutSenderQuery stamped[count] = {}, unstamped[count] = {};
+    for (int i = 0; i < count; i++)
+        stamped[i].name = unstamped[i].name = names[i];
+    SpoutLockPolicy policy{ SPOUT_LOCK_TRY, 0, 0, 0 };
+
+    SpoutSenderSnapshot entries[count];
+    static char snapshotNames[count * SpoutMaxSenderNameLen];
+
+    size_t total = 0;
+    int snapshot = 0;
+    auto pass = [&]() {
+        for (int i = 0; i < count; i++)
+            receiver.FindSenderName(names[i]);
+        const SpoutSenderNameTable* table = receiver.GetSenderNameTable();
+        for (int i = 0; table && i < table->Size(); i++)
+            total += (*table)[i].size();
+        receiver.CheckSenders(stamped, count, policy);
+        for (auto& query : unstamped) query.stamp = 0;
+        receiver.CheckSenders(unstamped, count, policy);
+        snapshot = receiver.GetSenderSnapshot(entries, count,
+            snapshotNames, sizeof(snapshotNames), policy);
+    };
+
+    pass();
+    pass();
+
+    uint64_t before = Allocations();
+    for (int i = 0; i < 100; i++) pass();
+    uint64_t allocations = Allocations() - before;
+    printf("find/enumerate/check/snapshot x100 (%zu character names) : %llu allocations\n",
+        strlen(names[0]), (unsigned long long)allocations);
+    CHECK(allocations == 0);
+    CHECK(total > 0);
+    CHECK(snapshot == count);
+
+    for (int i = 0; i < count; i++) {
+        CHECK(stamped[i].result == SPOUT_CHECK_SUCCESS || stamped[i].result == SPOUT_CHECK_UNCHANGED);
+        CHECK(unstamped[i].result == SPOUT_CHECK_SUCCESS);
+    }
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("allocation");
+
+    // Register and release don't scale with the size of the set
+    {
+        spoutSenderNames names;
+        uint64_t few = CycleAllocations(names, 4);
+        uint64_t many = CycleAllocations(names, 64);
+        printf("register/release x100 : %llu allocations (4 senders), %llu (64 senders)\n",
+            (unsigned long long)few, (unsigned long long)many);
+        CHECK(few == 0);
+        CHECK(many == 0);
+    }
+
+    // Receiver paths with short names, and with names longer than the
+    // small string buffer of std::string, as most real sender names are
+    ReceiverAllocations("Sender%03d");
+    ReceiverAllocations("Resolume Arena Composition %03d - Main Output");
+
+    return SpoutTest::Finish("AllocationTest");
+}
@@ -0,0 +1,131 @@
+// Sender check time per frame with 1 to 128 receivers : one CheckSender
+// call per receiver with the sender set read each time as before the batch
+// query, and one CheckSenders call for all of them with the info stamps
+// (as ReceiverPoller does)
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+#include <vector>
+
+namespace {
+
+const double Duration = 0.3; // seconds per measurement
+
+class Registry : public spoutSenderNames
+{
+public:
+
+    // CheckSender before the batch query : the set is locked and parsed
+    // for every receiver
+    bool checkUncached(const char* name, SharedTextureInfo& info)
+    {
+        std::set<std::string> names;
+        if (!CreateSenderSet()) return false;
+        char* buf = m_senderNames.Lock();
+        if (!buf) return false;
+        readSenderSetFromBuffer(buf, names, GetMaxSenders());
+        m_senderNames.Unlock();
+        if (names.find(name) == names.end()) return false;
+        return getSharedInfo(name, &info);
+    }
+};
+
+// Average time per frame in microseconds
+template <typename Function>
+double MicrosecondsPerFrame(Function frame)
+{
+    uint64_t start = SpoutTest::Nanoseconds();
+    uint64_t end = start + (uint64_t)(Duration * 1e9);
+    uint64_t frames = 0, now;
+    do
+    {
+        frame();
+        frames++;
+        now = SpoutTest::Nanoseconds();
+    }
+    while (now < end);
+    return (double)(now - start) / (double)frames * 1e-3;
+}
+
+// Lock acquisitions of the sender set map
+uint64_t SetLocks()
+{
+    SpoutLockStatsData data[64];
+    int count = SpoutLockStats::Snapshot(data, 64);
+    for (int i = 0; i < count && i < 64; i++)
+        if (strcmp(data[i].name, "SpoutSenderNames") == 0)
+            return data[i].acquisitions;
+    return 0;
+}
+
+} // namespace
+
+int main()
+{
+    printf("CheckSendersBench : us per frame (set locks per frame)\n");
+
+    const SpoutLockPolicy policy = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+
+    for (int count = 1; count <= 128; count *= 2)
+    {
+        char prefix[32];
+        snprintf(prefix, sizeof(prefix), "checksenders%d_", count);
+        SpoutTest::UseNamespace(prefix);
+
+        Registry sender, receiver;
+        sender.SetMaxSenders(128);
+        receiver.SetMaxSenders(128);
+
+        std::vector<std::string> names(count);
+        std::vector<SpoutSenderQuery> queries(count);
+        for (int i = 0; i < count; i++)
+        {
+            char name[64];
+            snprintf(name, sizeof(name), "Sender %03d", i);
+            names[i] = name;
+            CHECK(sender.CreateSender(name, 64, 64, LongToHandle(i + 1)));
+        }
+
+        auto separate = [&] {
+            SharedTextureInfo info;
+            for (int i = 0; i < count; i++)
+                receiver.checkUncached(names[i].c_str(), info);
+        };
+
+        auto batched = [&] {
+            for (int i = 0; i < count; i++) queries[i].name = names[i].c_str();
+            receiver.CheckSenders(queries.data(), count, policy);
+        };
+
+        separate();
+        batched();
+        for (int i = 0; i < count; i++)
+            CHECK(queries[i].result == SPOUT_CHECK_SUCCESS ||
+                  queries[i].result == SPOUT_CHECK_UNCHANGED);
+
+        SpoutLockStats::Enable(true);
+
+        uint64_t locks = SetLocks();
+        separate();
+        uint64_t separateLocks = SetLocks() - locks;
+
+        locks = SetLocks();
+        batched();
+        uint64_t batchedLocks = SetLocks() - locks;
+
+        SpoutLockStats::Enable(false);
+
+        double before = MicrosecondsPerFrame(separate);
+        double after = MicrosecondsPerFrame(batched);
+
+        printf("  %3d receivers : separate %8.2f us (%3llu)  batched %6.2f us (%llu)\n",
+               count, before, (unsigned long long)separateLocks,
+               after, (unsigned long long)batchedLocks);
+
+        CHECK(batchedLocks == 0);
+
+        SpoutTest::RemoveNamespace();
+    }
+
+    return SpoutTest::Finish("CheckSendersBench");
+}
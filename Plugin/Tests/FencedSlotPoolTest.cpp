@@ -0,0 +1,64 @@
+// FencedSlotPool : slots are reused once the GPU has passed their fence,
+// and a frame submitted every frame needs only as many slots as there are
+// frames in flight
+
+#include "Test.h"
+#include "FencedSlotPool.h"
+
+using KlakSpout::FencedSlotPool;
+
+int main()
+{
+    // New slots while the others are in use or in flight
+    {
+        FencedSlotPool pool;
+        bool added;
+        CHECK(pool.acquire(0, added) == 0 && added);
+        CHECK(pool.acquire(0, added) == 1 && added); // 0 is in use
+        pool.retire(0, 5);
+        pool.retire(1, 6);
+        CHECK(pool.acquire(4, added) == 2 && added); // None completed
+        pool.retire(2, 7);
+
+        // Reused in index order once completed
+        CHECK(pool.acquire(5, added) == 0 && !added);
+        CHECK(pool.acquire(7, added) == 1 && !added);
+        CHECK(pool.acquire(7, added) == 2 && !added);
+        CHECK(pool.size() == 3);
+
+        // A slot retired with 0 (failed submission) is free right away.
+        pool.retire(1, 0);
+        CHECK(pool.acquire(0, added) == 1 && !added);
+    }
+
+    // Steady state : one submission per frame with the GPU two frames
+    // behind. The pool stops growing at three slots.
+    {
+        FencedSlotPool pool;
+        bool added;
+        uint64_t completed = 0;
+        for (uint64_t frame = 1; frame <= 1000; frame++)
+        {
+            int slot = pool.acquire(completed, added);
+            CHECK(slot >= 0 && slot < 3);
+            pool.retire(slot, frame);
+            if (frame >= 2) completed = frame - 2;
+        }
+        CHECK(pool.size() == 3);
+    }
+
+    // A stalled GPU : the pool grows by one slot per frame, and all the
+    // slots are reused once the GPU catches up.
+    {
+        FencedSlotPool pool;
+        bool added;
+        for (uint64_t frame = 1; frame <= 10; frame++)
+            pool.retire(pool.acquire(0, added), frame);
+        CHECK(pool.size() == 10);
+        for (int i = 0; i < 10; i++)
+            CHECK(pool.acquire(10, added) == i && !added);
+        CHECK(pool.acquire(10, added) == 10 && added);
+    }
+
+    return SpoutTest::Finish("FencedSlotPoolTest");
+}
@@ -0,0 +1,81 @@
+// FindSenderName cost with 8, 64 and 256 registered senders, re-reading
+// the sender set on every call as before the generation counter, and
+// with the cached set
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+
+namespace {
+
+const double Duration = 0.3; // seconds per measurement
+
+class Registry : public spoutSenderNames
+{
+public:
+
+    // FindSenderName before the generation counter :
+    // lock the map and rebuild the set on every call
+    bool findUncached(const char* name)
+    {
+        std::set<std::string> names;
+        if (!CreateSenderSet()) return false;
+        char* buf = m_senderNames.Lock();
+        if (!buf) return false;
+        readSenderSetFromBuffer(buf, names, GetMaxSenders());
+        m_senderNames.Unlock();
+        return names.find(name) != names.end();
+    }
+};
+
+template <typename Function>
+double NanosecondsPerCall(Function func)
+{
+    uint64_t start = SpoutTest::Nanoseconds();
+    uint64_t end = start + (uint64_t)(Duration * 1e9);
+    uint64_t calls = 0, now;
+    do
+    {
+        for (int i = 0; i < 16; i++) func();
+        calls += 16;
+        now = SpoutTest::Nanoseconds();
+    }
+    while (now < end);
+    return (double)(now - start) / (double)calls;
+}
+
+} // namespace
+
+int main()
+{
+    printf("FindSenderBench : ns per FindSenderName\n");
+
+    for (int count : { 8, 64, 256 })
+    {
+        char prefix[32];
+        snprintf(prefix, sizeof(prefix), "findsender%d_", count);
+        SpoutTest::UseNamespace(prefix);
+
+        Registry registry;
+        registry.SetMaxSenders(256);
+        char name[64];
+        for (int i = 0; i < count; i++)
+        {
+            snprintf(name, sizeof(name), "Sender %03d", i);
+            CHECK(registry.RegisterSenderName(name));
+        }
+        snprintf(name, sizeof(name), "Sender %03d", count / 2);
+
+        CHECK(registry.findUncached(name));
+        CHECK(registry.FindSenderName(name));
+
+        double before = NanosecondsPerCall([&] { registry.findUncached(name); });
+        double after = NanosecondsPerCall([&] { registry.FindSenderName(name); });
+
+        printf("  %3d senders : re-read %9.0f ns  cached %6.0f ns  (x%.0f)\n",
+               count, before, after, before / after);
+
+        SpoutTest::RemoveNamespace();
+    }
+
+    return SpoutTest::Finish("FindSenderBench");
+}
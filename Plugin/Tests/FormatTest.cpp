@@ -0,0 +1,73 @@
+// Format.h : the conversions between KlakSpout::Format and DXGI_FORMAT,
+// the typeless groups and the shared texture format negotiation
+// (built against Tests/Mock/dxgiformat.h)
+
+#include "Test.h"
+#include "Format.h"
+
+namespace {
+
+using namespace KlakSpout;
+
+const Format Formats[] =
+  { Format::RGBA32, Format::RGBA32_SRGB, Format::BGRA32,
+    Format::BGRA32_SRGB, Format::RGBAHalf, Format::RGBAFloat };
+
+} // namespace
+
+int main()
+{
+    // Round trips
+    for (auto format : Formats)
+        CHECK(ToFormat(ToDXGIFormat(format)) == format);
+    CHECK(ToDXGIFormat(Format::Unknown) == DXGI_FORMAT_UNKNOWN);
+    CHECK(ToFormat(DXGI_FORMAT_R10G10B10A2_UNORM) == Format::Unknown);
+
+    // Groups
+    CHECK(ToTypeless(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) == DXGI_FORMAT_R8G8B8A8_TYPELESS);
+    CHECK(ToTypeless(DXGI_FORMAT_B8G8R8A8_TYPELESS) == DXGI_FORMAT_B8G8R8A8_TYPELESS);
+    CHECK(ToTypeless(DXGI_FORMAT_R16G16B16A16_FLOAT) == DXGI_FORMAT_R16G16B16A16_TYPELESS);
+    CHECK(ToTypeless(DXGI_FORMAT_B8G8R8X8_UNORM) == DXGI_FORMAT_UNKNOWN);
+
+    // The requested format is kept when the source is in its group.
+    for (auto format : Formats)
+        CHECK(NegotiateFormat(format, ToDXGIFormat(format)) == ToDXGIFormat(format));
+    CHECK(NegotiateFormat(Format::RGBA32_SRGB, DXGI_FORMAT_R8G8B8A8_UNORM)
+          == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB);
+    CHECK(NegotiateFormat(Format::BGRA32, DXGI_FORMAT_B8G8R8A8_TYPELESS)
+          == DXGI_FORMAT_B8G8R8A8_UNORM);
+
+    // Otherwise the linear typed format of the source group is used.
+    CHECK(NegotiateFormat(Format::RGBA32, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB)
+          == DXGI_FORMAT_B8G8R8A8_UNORM);
+    CHECK(NegotiateFormat(Format::RGBA32, DXGI_FORMAT_R16G16B16A16_FLOAT)
+          == DXGI_FORMAT_R16G16B16A16_FLOAT);
+    CHECK(NegotiateFormat(Format::RGBAHalf, DXGI_FORMAT_R32G32B32A32_FLOAT)
+          == DXGI_FORMAT_R32G32B32A32_FLOAT);
+    CHECK(NegotiateFormat(Format::Unknown, DXGI_FORMAT_R8G8B8A8_UNORM_SRGB)
+          == DXGI_FORMAT_R8G8B8A8_UNORM);
+
+    // Sources that can't be shared without a conversion
+    for (auto format : Formats)
+    {
+        CHECK(NegotiateFormat(format, DXGI_FORMAT_UNKNOWN) == DXGI_FORMAT_UNKNOWN);
+        CHECK(NegotiateFormat(format, DXGI_FORMAT_R10G10B10A2_UNORM) == DXGI_FORMAT_UNKNOWN);
+        CHECK(NegotiateFormat(format, DXGI_FORMAT_B8G8R8X8_UNORM) == DXGI_FORMAT_UNKNOWN);
+    }
+
+    // The result is always copyable from the source (same group).
+    for (auto format : Formats)
+        for (int source = 0; source < 120; source++)
+        {
+            auto shared = NegotiateFormat(format, (DXGI_FORMAT)source);
+            if (shared == DXGI_FORMAT_UNKNOWN) continue;
+            CHECK(ToTypeless(shared) == ToTypeless((DXGI_FORMAT)source));
+            CHECK(ToFormat(shared) != Format::Unknown);
+        }
+
+    CHECK(BytesPerPixel(DXGI_FORMAT_R16G16B16A16_FLOAT) == 8);
+    CHECK(BytesPerPixel(DXGI_FORMAT_R32G32B32A32_FLOAT) == 16);
+    CHECK(BytesPerPixel(DXGI_FORMAT_B8G8R8A8_UNORM_SRGB) == 4);
+
+    return SpoutTest::Finish("FormatTest");
+}
@@ -0,0 +1,90 @@
+// Sender set generation ("SpoutSenderNamesGeneration") and the parsed
+// sender set cache it guards
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+#include <thread>
+
+namespace {
+
+// Access to the generation and the sender set map
+class Registry : public spoutSenderNames
+{
+public:
+
+    using spoutSenderNames::getSenderSetGeneration;
+    using spoutSenderNames::writeBufferFromSenderSet;
+
+    // Change the first map as a legacy application does, without the generation
+    void legacyWrite(const std::set<std::string>& names)
+    {
+        char* buf = m_senderNames.Lock();
+        writeBufferFromSenderSet(names, buf, GetMaxSenders());
+        m_senderNames.Unlock();
+    }
+};
+
+uint64_t SetLocks()
+{
+    SpoutLockStatsData data[16];
+    int count = SpoutLockStats::Snapshot(data, 16);
+    for (int i = 0; i < count && i < 16; i++)
+        if (strcmp(data[i].name, "SpoutSenderNames") == 0)
+            return data[i].acquisitions;
+    return 0;
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("generation");
+
+    Registry sender, receiver;
+
+    HANDLE handle = LongToHandle(1);
+    CHECK(sender.CreateSender("One", 64, 64, handle));
+    CHECK(receiver.FindSenderName("One"));
+    DWORD g1 = receiver.getSenderSetGeneration();
+    CHECK(g1 != 0);
+
+    // Registration and release bump it, a failed registration doesn't
+    CHECK(sender.CreateSender("Two", 64, 64, handle));
+    DWORD g2 = receiver.getSenderSetGeneration();
+    CHECK(g2 != g1);
+    CHECK(!sender.RegisterSenderName("Two"));
+    CHECK(receiver.getSenderSetGeneration() == g2);
+    CHECK(sender.ReleaseSenderName("One"));
+    DWORD g3 = receiver.getSenderSetGeneration();
+    CHECK(g3 != g2);
+
+    // A registration by another object is seen immediately
+    CHECK(receiver.FindSenderName("Two"));
+    CHECK(!receiver.FindSenderName("Three"));
+    CHECK(sender.CreateSender("Three", 64, 64, handle));
+    CHECK(receiver.FindSenderName("Three"));
+
+    // Unchanged generation : the set map is not locked again
+    SpoutLockStats::Enable(true);
+    uint64_t before = SetLocks();
+    for (int i = 0; i < 100; i++) receiver.FindSenderName("Two");
+    CHECK(SetLocks() == before);
+    SpoutLockStats::Enable(false);
+
+    // Orphans (names without an info map) removed by CleanSenders
+    // bump the generation
+    CHECK(sender.RegisterSenderName("Orphan"));
+    DWORD g4 = receiver.getSenderSetGeneration();
+    spoutSenderNames cleaner;
+    cleaner.CleanSenders();
+    CHECK(!receiver.FindSenderName("Orphan"));
+    CHECK(receiver.getSenderSetGeneration() != g4);
+
+    // A legacy write is seen after the revalidation time
+    CHECK(receiver.FindSenderName("Two"));
+    sender.legacyWrite({ "Legacy", "Three", "Two" });
+    std::this_thread::sleep_for(std::chrono::milliseconds(SpoutSenderSetRevalidateTime + 50));
+    CHECK(receiver.FindSenderName("Legacy"));
+
+    return SpoutTest::Finish("GenerationTest");
+}
@@ -0,0 +1,59 @@
+// getSharedInfo calls per second with the cached sender info map,
+// compared with opening the map on every call as before the cache
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+
+namespace {
+
+const double Duration = 0.5; // seconds per measurement
+
+// Calls per second of a function
+template <typename Function>
+double Measure(Function func)
+{
+    uint64_t start = SpoutTest::Nanoseconds();
+    uint64_t end = start + (uint64_t)(Duration * 1e9);
+    uint64_t calls = 0, now;
+    do
+    {
+        for (int i = 0; i < 100; i++) func();
+        calls += 100;
+        now = SpoutTest::Nanoseconds();
+    }
+    while (now < end);
+    return (double)calls * 1e9 / (double)(now - start);
+}
+
+// Sender info read as getSharedInfo did before the cache
+bool UncachedRead(const char* name, SharedTextureInfo* info)
+{
+    SpoutSharedMemory mem;
+    if (!mem.Open(name)) return false;
+    char* buf = mem.Lock();
+    if (!buf) return false;
+    memcpy(info, buf, sizeof(SharedTextureInfo));
+    mem.Unlock();
+    return true;
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("infocache");
+
+    spoutSenderNames sender, receiver;
+    sender.CreateSender("Bench", 1920, 1080, LongToHandle(0x100), 87);
+
+    SharedTextureInfo info;
+    double uncached = Measure([&] { UncachedRead("Bench", &info); });
+    double cached = Measure([&] { receiver.getSharedInfo("Bench", &info); });
+
+    CHECK(receiver.getSharedInfo("Bench", &info) && info.width == 1920);
+
+    printf("getSharedInfo without cache : %10.0f calls/s\n", uncached);
+    printf("getSharedInfo with cache    : %10.0f calls/s (x%.1f)\n", cached, cached / uncached);
+
+    return SpoutTest::Finish("InfoCacheBench");
+}
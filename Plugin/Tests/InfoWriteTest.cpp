@@ -0,0 +1,91 @@
+// SetSenderInfo writes : unchanged info doesn't lock or write the sender
+// info map, and a change only rewrites the texture fields (the row order
+// flag of SetSenderRowOrder is kept)
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+
+namespace {
+
+const SpoutLockPolicy WaitPolicy = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+
+class Registry : public spoutSenderNames
+{
+public:
+
+    using spoutSenderNames::getSenderProcessId;
+};
+
+// Lock acquisitions of a sender info map
+uint64_t InfoLocks(const char* name)
+{
+    SpoutLockStatsData data[64];
+    int count = SpoutLockStats::Snapshot(data, 64);
+    for (int i = 0; i < count && i < 64; i++)
+        if (strcmp(data[i].name, name) == 0)
+            return data[i].acquisitions;
+    return 0;
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("infowrite");
+
+    Registry sender, receiver;
+    HANDLE handle = LongToHandle(1);
+    CHECK(sender.CreateSender("Writer", 64, 64, handle, 87));
+
+    SpoutSenderQuery query = {};
+    query.name = "Writer";
+    receiver.CheckSenders(&query, 1, WaitPolicy);
+    CHECK(query.result == SPOUT_CHECK_SUCCESS);
+
+    // Same info every frame : no lock, the stamp stays
+    SpoutLockStats::Enable(true);
+    uint64_t locks = InfoLocks("Writer");
+    for (int i = 0; i < 1000; i++)
+        CHECK(sender.UpdateSender("Writer", 64, 64, handle, 87));
+    CHECK(InfoLocks("Writer") == locks);
+
+    receiver.CheckSenders(&query, 1, WaitPolicy);
+    CHECK(query.result == SPOUT_CHECK_UNCHANGED);
+
+    // A change : one write, seen by the receiver
+    locks = InfoLocks("Writer");
+    CHECK(sender.UpdateSender("Writer", 128, 32, LongToHandle(2), 87));
+    CHECK(InfoLocks("Writer") == locks + 1);
+    SpoutLockStats::Enable(false);
+
+    receiver.CheckSenders(&query, 1, WaitPolicy);
+    CHECK(query.result == SPOUT_CHECK_SUCCESS);
+    CHECK(query.width == 128 && query.height == 32);
+    CHECK(query.handle == LongToHandle(2));
+
+    // The fields written on creation are kept
+    SharedTextureInfo info;
+    CHECK(receiver.getSharedInfo("Writer", &info));
+    CHECK(Registry::getSenderProcessId(&info) == GetCurrentProcessId());
+    char path[MAX_PATH];
+    GetModuleFileNameA(NULL, path, MAX_PATH);
+    CHECK(strcmp((const char*)info.description, path) == 0);
+
+    // Row order flag : reported by CheckSenders, kept on a resize
+    CHECK(query.flags == 0);
+    CHECK(sender.SetSenderRowOrder("Writer", true));
+    receiver.CheckSenders(&query, 1, WaitPolicy);
+    CHECK(query.result == SPOUT_CHECK_SUCCESS);
+    CHECK(query.flags == SpoutInfoBottomUp);
+
+    CHECK(sender.UpdateSender("Writer", 64, 64, handle, 87));
+    receiver.CheckSenders(&query, 1, WaitPolicy);
+    CHECK(query.result == SPOUT_CHECK_SUCCESS);
+    CHECK(query.width == 64 && query.flags == SpoutInfoBottomUp);
+
+    CHECK(sender.SetSenderRowOrder("Writer", false));
+    receiver.CheckSenders(&query, 1, WaitPolicy);
+    CHECK(query.result == SPOUT_CHECK_SUCCESS && query.flags == 0);
+
+    return SpoutTest::Finish("InfoWriteTest");
+}
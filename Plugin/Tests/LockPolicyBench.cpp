@@ -0,0 +1,145 @@
+// Render thread time per CheckSender call under each lock policy while
+// another thread holds the maps (legacy sender info written under the
+// mutex, and the sender set map). The non-waiting policies must never
+// block, and their CPU time per call has to stay within the budget. The
+// wall time is reported as well, but includes preemptions.
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+const double Duration = 0.4; // seconds per policy
+const int HoldTime = 2000; // usec the maps are held
+const int HoldInterval = 5000; // usec between holds
+
+// Time of a CheckSender call without waiting (usec), added to the
+// deadline of the deadline policy
+const uint64_t Budget = 100;
+
+// Interrupts and cache misses accounted to the thread (usec)
+const uint64_t Slack = 400;
+
+struct Policy
+{
+    const char* label;
+    SpoutLockPolicy policy;
+};
+
+const Policy Policies[] =
+{
+    { "wait (67 ms)", { SPOUT_LOCK_WAIT, 0, 0, 0 } },
+    { "try", { SPOUT_LOCK_TRY, 0, 0, 0 } },
+    { "spin 16 + wait 1 ms", { SPOUT_LOCK_SPIN, 16, 1, 0 } },
+    { "deadline 50 usec", { SPOUT_LOCK_DEADLINE, 0, 0, 50 } },
+};
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("lockpolicy");
+
+    // Legacy sender : registered, info without the sequence word
+    spoutSenderNames sender;
+    CHECK(sender.RegisterSenderName("Legacy"));
+    SpoutSharedMemory info;
+    CHECK(info.Create("Legacy", sizeof(SharedTextureInfo)) == SPOUT_CREATE_SUCCESS);
+    SharedTextureInfo texture = {};
+    texture.width = 1920;
+    texture.height = 1080;
+    memcpy(info.Lock(), &texture, sizeof(texture));
+    info.Unlock();
+
+    SpoutSharedMemory names;
+    CHECK(names.Open("SpoutSenderNames"));
+
+    std::atomic<bool> stop{false};
+    std::thread holder([&] {
+        for (int i = 0; !stop; i++)
+        {
+            // Alternate between the info map and both maps
+            bool both = i % 2;
+            info.Lock();
+            if (both) names.Lock();
+            std::this_thread::sleep_for(std::chrono::microseconds(HoldTime));
+            if (both) names.Unlock();
+            info.Unlock();
+            std::this_thread::sleep_for(std::chrono::microseconds(HoldInterval));
+        }
+    });
+
+    printf("LockPolicyBench : CheckSender per call, maps held %d usec every %d usec\n",
+           HoldTime, HoldTime + HoldInterval);
+
+    uint64_t waitMax = 0, tryMax = 0, tryBusy = 0, tryBlocked = 0;
+    uint64_t deadlineMax = 0, deadlineBlocked = 0;
+
+    for (const Policy& p : Policies)
+    {
+        // The first call opens the maps (once per receiver).
+        spoutSenderNames receiver;
+        {
+            unsigned int width, height;
+            HANDLE handle;
+            DWORD format;
+            receiver.CheckSender("Legacy", p.policy, width, height, handle, format);
+        }
+
+        SpoutTest::Samples samples, cpu;
+        uint64_t busy = 0, failed = 0, blocked = 0;
+        uint64_t end = SpoutTest::Nanoseconds() + (uint64_t)(Duration * 1e9);
+        while (SpoutTest::Nanoseconds() < end)
+        {
+            unsigned int width, height;
+            HANDLE handle;
+            DWORD format;
+            long blocks = SpoutTest::Blocks();
+            uint64_t cpuStart = SpoutTest::ThreadNanoseconds();
+            uint64_t start = SpoutTest::Nanoseconds();
+            SpoutCheckResult result = receiver.CheckSender("Legacy", p.policy, width, height, handle, format);
+            samples.add(SpoutTest::Nanoseconds() - start);
+            cpu.add(SpoutTest::ThreadNanoseconds() - cpuStart);
+            if (SpoutTest::Blocks() != blocks) blocked++;
+            if (result == SPOUT_CHECK_BUSY) busy++;
+            if (result == SPOUT_CHECK_FAILED) failed++;
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+        printf("  %-22s calls %6zu  p50 %7.1f us  p99 %8.1f us  max %8.1f us  "
+               "cpu max %7.1f us  busy %4llu  blocked %4llu\n",
+               p.label, samples.count(),
+               samples.percentile(0.5) / 1e3, samples.percentile(0.99) / 1e3,
+               samples.max() / 1e3, cpu.max() / 1e3,
+               (unsigned long long)busy, (unsigned long long)blocked);
+        CHECK(failed == 0);
+        if (p.policy.mode == SPOUT_LOCK_WAIT) waitMax = samples.max();
+        if (p.policy.mode == SPOUT_LOCK_TRY)
+        {
+            tryMax = cpu.max();
+            tryBusy = busy;
+            tryBlocked = blocked;
+        }
+        if (p.policy.mode == SPOUT_LOCK_DEADLINE)
+        {
+            deadlineMax = cpu.max();
+            deadlineBlocked = blocked;
+        }
+    }
+
+    stop = true;
+    holder.join();
+
+    // The waiting policy blocks behind the holder, the try policy reports
+    // the lock as busy instead, and neither the try nor the deadline
+    // policy blocks or runs beyond its budget.
+    CHECK(waitMax > 500000);
+    CHECK(tryBusy > 0);
+    CHECK(tryBlocked == 0);
+    CHECK(deadlineBlocked == 0);
+    CHECK(tryMax < (Budget + Slack) * 1000);
+    CHECK(deadlineMax < (Policies[3].policy.budget + Budget + Slack) * 1000);
+
+    return SpoutTest::Finish("LockPolicyBench");
+}
@@ -0,0 +1,138 @@
+// SpoutLockStats counters under induced contention, and the release of
+// the table entries of closed maps
+
+#include "Test.h"
+#include "Spout/SpoutSharedMemory.h"
+#include <thread>
+
+namespace {
+
+const SpoutLockPolicy TryPolicy = { SPOUT_LOCK_TRY, 0, 0, 0 };
+
+// Counters of a map name, false if it isn't in the table
+bool Lookup(const char* name, SpoutLockStatsData& out)
+{
+    std::vector<SpoutLockStatsData> data(SpoutLockStats::Snapshot(nullptr, 0));
+    int count = SpoutLockStats::Snapshot(data.data(), (int)data.size());
+    for (int i = 0; i < count && i < (int)data.size(); i++)
+    {
+        if (strcmp(data[i].name, name) != 0) continue;
+        out = data[i];
+        return true;
+    }
+    return false;
+}
+
+uint64_t Waits(const SpoutLockStatsData& data, int fromBucket)
+{
+    uint64_t count = 0;
+    for (int b = fromBucket; b < SpoutLockStatsBuckets; b++)
+        count += data.waitHistogram[b];
+    return count;
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("lockstats");
+
+    // Nothing is recorded, nor any entry created, while disabled
+    {
+        SpoutSharedMemory map;
+        map.Create("Quiet", 64);
+        map.Lock();
+        map.Unlock();
+        SpoutLockStatsData data;
+        CHECK(!Lookup("Quiet", data));
+    }
+
+    SpoutLockStats::Enable(true);
+
+    SpoutSharedMemory holder, waiter;
+    CHECK(holder.Create("Contended", 64) == SPOUT_CREATE_SUCCESS);
+    CHECK(waiter.Open("Contended"));
+
+    // Re-entrant locks
+    holder.Lock();
+    holder.Lock();
+    holder.Unlock();
+    holder.Unlock();
+
+    // A thread holds the lock for 10 msec at a time
+    const int Rounds = 5;
+    std::atomic<bool> held{false};
+    std::atomic<int> round{0};
+    std::thread thread([&] {
+        for (int i = 0; i < Rounds; i++)
+        {
+            holder.Lock();
+            held = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            held = false;
+            holder.Unlock();
+            while (round.load() <= i) std::this_thread::yield();
+        }
+    });
+
+    int timeouts = 0;
+    for (int i = 0; i < Rounds; i++)
+    {
+        while (!held) std::this_thread::yield();
+        // Fails while the lock is held, then waits for it
+        if (!waiter.Lock(TryPolicy)) timeouts++;
+        if (waiter.Lock()) waiter.Unlock();
+        round++;
+    }
+    thread.join();
+
+    SpoutLockStatsData data;
+    CHECK(Lookup("Contended", data));
+    CHECK(data.reentrant == 1);
+    CHECK(data.timeouts == (uint64_t)timeouts);
+    CHECK(timeouts > 0);
+    // holder (1 + Rounds) and waiter (Rounds) acquisitions
+    CHECK(data.acquisitions == (uint64_t)(1 + 2 * Rounds));
+    // Blocked waits land in the millisecond buckets (>= 1024 usec)
+    CHECK(Waits(data, 11) >= (uint64_t)Rounds - 1);
+    uint64_t histogram = Waits(data, 0);
+    CHECK(histogram == data.acquisitions + data.timeouts);
+
+    // Closed maps with records are kept until Reset
+    holder.Close();
+    waiter.Close();
+    CHECK(Lookup("Contended", data));
+    SpoutLockStats::Reset();
+    CHECK(!Lookup("Contended", data));
+
+    // A map closed without records is freed from the table
+    {
+        SpoutSharedMemory map;
+        map.Create("Unlocked", 64);
+        map.Lock(TryPolicy); // creates the entry
+        map.Unlock();
+        CHECK(Lookup("Unlocked", data));
+        SpoutLockStats::Reset();
+        CHECK(Lookup("Unlocked", data) && data.acquisitions == 0);
+    }
+    CHECK(!Lookup("Unlocked", data));
+
+    // Many short-lived maps don't grow the table
+    SpoutLockStats::Reset();
+    for (int i = 0; i < 1000; i++)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "Transient%d", i);
+        SpoutSharedMemory map;
+        map.Create(name, 64);
+        map.Lock();
+        map.Unlock();
+        map.Close();
+        SpoutLockStats::Reset();
+    }
+    CHECK(SpoutLockStats::Snapshot(nullptr, 0) == 0);
+
+    SpoutLockStats::Enable(false);
+
+    return SpoutTest::Finish("LockStatsTest");
+}
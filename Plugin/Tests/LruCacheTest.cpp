@@ -0,0 +1,155 @@
+// LruCache : the order of use, and the shared resource cache steps
+// (ResourceCache.h) against a mock device : sources flipped back and forth
+// are opened once, and the resources of closed or resized senders are
+// released once evicted
+
+#include "Test.h"
+#include "LruCache.h"
+#include <memory>
+
+namespace {
+
+using KlakSpout::LruCache;
+
+// Mock device : counts the opens of shared handles
+struct MockResource
+{
+    int handle;
+};
+
+struct MockDevice
+{
+    int opens = 0;
+
+    std::shared_ptr<MockResource> OpenSharedResource(int handle)
+    {
+        opens++;
+        return handle ? std::make_shared<MockResource>(MockResource{handle}) : nullptr;
+    }
+};
+
+struct Key
+{
+    MockDevice* device;
+    int handle;
+
+    bool operator == (const Key& other) const
+    {
+        return device == other.device && handle == other.handle;
+    }
+};
+
+// SharedResourceCache::open and evict with the mock device
+class ResourceCache
+{
+public:
+
+    std::shared_ptr<MockResource> open(MockDevice& device, int handle)
+    {
+        if (auto cached = _entries.find(Key{&device, handle})) return *cached;
+        auto resource = device.OpenSharedResource(handle);
+        if (resource) _entries.insert(Key{&device, handle}, resource);
+        return resource;
+    }
+
+    void evict(int handle)
+    {
+        if (!handle) return;
+        _entries.evict([=](const Key& key) { return key.handle == handle; });
+    }
+
+    size_t size() const { return _entries.size(); }
+
+private:
+
+    LruCache<Key, std::shared_ptr<MockResource>, 4> _entries;
+};
+
+// ReceiverSubscription::apply steps : evict the previous handle when the
+// sender is gone (handle 0) or shares another handle
+struct MockReceiver
+{
+    int handle = 0;
+    std::shared_ptr<MockResource> texture;
+
+    void apply(ResourceCache& cache, MockDevice& device, int newHandle)
+    {
+        if (texture && newHandle == handle) return;
+        if (newHandle != handle) cache.evict(handle);
+        texture = cache.open(device, newHandle);
+        handle = newHandle;
+    }
+};
+
+} // namespace
+
+int main()
+{
+    // Order of use : the least recently used entry is dropped
+    {
+        LruCache<int, int, 3> cache;
+        for (int i = 1; i <= 3; i++) cache.insert(i, i * 10);
+        CHECK(cache.find(1) && *cache.find(1) == 10);
+        cache.insert(4, 40); // Drops 2
+        CHECK(cache.size() == 3);
+        CHECK(!cache.find(2));
+        CHECK(cache.find(1) && cache.find(3) && cache.find(4));
+        CHECK(cache.evict([](int key) { return key > 2; }) == 2);
+        CHECK(cache.size() == 1);
+        cache.clear();
+        CHECK(!cache.find(1));
+    }
+
+    // Receivers flipping between two sources : one open per source
+    {
+        MockDevice device;
+        ResourceCache cache;
+        MockReceiver receiver;
+        for (int i = 0; i < 100; i++)
+            receiver.texture = cache.open(device, i % 2 ? 0x100 : 0x200);
+        CHECK(device.opens == 2);
+
+        // Other receivers share the resource
+        MockReceiver other;
+        other.apply(cache, device, 0x100);
+        CHECK(device.opens == 2);
+        CHECK(other.texture == cache.open(device, 0x100));
+
+        // The key includes the device
+        MockDevice second;
+        CHECK(cache.open(second, 0x100) != other.texture);
+        CHECK(second.opens == 1);
+    }
+
+    // A sender resized to another handle, then closed
+    {
+        MockDevice device;
+        ResourceCache cache;
+        MockReceiver receiver;
+
+        receiver.apply(cache, device, 0x100);
+        std::weak_ptr<MockResource> first = receiver.texture;
+
+        receiver.apply(cache, device, 0x300);
+        CHECK(device.opens == 2);
+        CHECK(cache.size() == 1);
+        CHECK(first.expired()); // Released, not kept alive by the cache
+
+        // Another receiver still holding the old texture keeps it
+        MockReceiver holder;
+        holder.apply(cache, device, 0x300);
+        std::weak_ptr<MockResource> second = holder.texture;
+        receiver.apply(cache, device, 0); // Sender closed
+        CHECK(!receiver.texture);
+        CHECK(cache.size() == 0);
+        CHECK(!second.expired());
+        holder.texture = nullptr;
+        CHECK(second.expired());
+
+        // A failed open isn't cached, so it's retried
+        receiver.apply(cache, device, 0);
+        CHECK(device.opens == 4);
+    }
+
+    return SpoutTest::Finish("LruCacheTest");
+}
@@ -0,0 +1,114 @@
+// Stand-in for the Windows SDK header on Linux (tests and benchmarks only)
+// Only the members used by the plugin. The values are the ones of the SDK.
+#pragma once
+
+#include <dxgi.h>
+
+typedef enum D3D11_USAGE
+{
+    D3D11_USAGE_DEFAULT = 0,
+    D3D11_USAGE_STAGING = 3
+} D3D11_USAGE;
+
+typedef enum D3D11_BIND_FLAG
+{
+    D3D11_BIND_SHADER_RESOURCE = 0x8,
+    D3D11_BIND_RENDER_TARGET = 0x20
+} D3D11_BIND_FLAG;
+
+typedef enum D3D11_CPU_ACCESS_FLAG
+{
+    D3D11_CPU_ACCESS_READ = 0x20000
+} D3D11_CPU_ACCESS_FLAG;
+
+typedef enum D3D11_RESOURCE_MISC_FLAG
+{
+    D3D11_RESOURCE_MISC_SHARED = 0x2
+} D3D11_RESOURCE_MISC_FLAG;
+
+typedef enum D3D11_MAP
+{
+    D3D11_MAP_READ = 1
+} D3D11_MAP;
+
+typedef enum D3D11_MAP_FLAG
+{
+    D3D11_MAP_FLAG_DO_NOT_WAIT = 0x100000
+} D3D11_MAP_FLAG;
+
+typedef enum D3D11_QUERY
+{
+    D3D11_QUERY_EVENT = 0
+} D3D11_QUERY;
+
+typedef enum D3D11_ASYNC_GETDATA_FLAG
+{
+    D3D11_ASYNC_GETDATA_DONOTFLUSH = 0x1
+} D3D11_ASYNC_GETDATA_FLAG;
+
+typedef struct D3D11_QUERY_DESC
+{
+    D3D11_QUERY Query;
+    UINT MiscFlags;
+} D3D11_QUERY_DESC;
+
+typedef struct D3D11_TEXTURE2D_DESC
+{
+    UINT Width;
+    UINT Height;
+    UINT MipLevels;
+    UINT ArraySize;
+    DXGI_FORMAT Format;
+    DXGI_SAMPLE_DESC SampleDesc;
+    D3D11_USAGE Usage;
+    UINT BindFlags;
+    UINT CPUAccessFlags;
+    UINT MiscFlags;
+} D3D11_TEXTURE2D_DESC;
+
+typedef struct D3D11_MAPPED_SUBRESOURCE
+{
+    void* pData;
+    UINT RowPitch;
+    UINT DepthPitch;
+} D3D11_MAPPED_SUBRESOURCE;
+
+struct D3D11_SUBRESOURCE_DATA;
+
+struct ID3D11Resource : IUnknown {};
+
+struct ID3D11Texture2D : ID3D11Resource
+{
+    virtual void GetDesc(D3D11_TEXTURE2D_DESC* desc) = 0;
+};
+
+struct ID3D11RenderTargetView : IUnknown {};
+struct ID3D11ShaderResourceView : IUnknown {};
+
+struct ID3D11Asynchronous : IUnknown {};
+struct ID3D11Query : ID3D11Asynchronous {};
+
+struct ID3D11DeviceContext : IUnknown
+{
+    virtual void CopyResource(ID3D11Resource* dest, ID3D11Resource* source) = 0;
+    virtual HRESULT Map(ID3D11Resource* resource, UINT subresource,
+                        D3D11_MAP type, UINT flags,
+                        D3D11_MAPPED_SUBRESOURCE* mapped) = 0;
+    virtual void Unmap(ID3D11Resource* resource, UINT subresource) = 0;
+    virtual void End(ID3D11Asynchronous* async) = 0;
+    virtual HRESULT GetData(ID3D11Asynchronous* async, void* data,
+                            UINT size, UINT flags) = 0;
+    virtual void Flush() = 0;
+};
+
+struct ID3D11Device : IUnknown
+{
+    virtual HRESULT CreateTexture2D(const D3D11_TEXTURE2D_DESC* desc,
+                                    const D3D11_SUBRESOURCE_DATA* data,
+                                    ID3D11Texture2D** texture) = 0;
+    virtual HRESULT OpenSharedResource(HANDLE handle, REFIID riid,
+                                       void** resource) = 0;
+    virtual HRESULT CreateQuery(const D3D11_QUERY_DESC* desc,
+                                ID3D11Query** query) = 0;
+    virtual void GetImmediateContext(ID3D11DeviceContext** context) = 0;
+};
@@ -0,0 +1,39 @@
+// Stand-in for the Windows SDK header on Linux (tests and benchmarks only)
+// Only the members used by the plugin. D3D11On12CreateDevice is defined by
+// the mock device (Tests/MockDevice.h).
+#pragma once
+
+#include <d3d11.h>
+#include <d3d12.h>
+
+typedef enum D3D_FEATURE_LEVEL
+{
+    D3D_FEATURE_LEVEL_11_0 = 0xb000
+} D3D_FEATURE_LEVEL;
+
+typedef struct D3D11_RESOURCE_FLAGS
+{
+    UINT BindFlags;
+    UINT MiscFlags;
+    UINT CPUAccessFlags;
+    UINT StructureByteStride;
+} D3D11_RESOURCE_FLAGS;
+
+struct ID3D11On12Device : IUnknown
+{
+    virtual HRESULT CreateWrappedResource(IUnknown* resource12,
+                                          const D3D11_RESOURCE_FLAGS* flags,
+                                          D3D12_RESOURCE_STATES inState,
+                                          D3D12_RESOURCE_STATES outState,
+                                          REFIID riid, void** resource11) = 0;
+    virtual void ReleaseWrappedResources(ID3D11Resource* const* resources,
+                                         UINT count) = 0;
+    virtual void AcquireWrappedResources(ID3D11Resource* const* resources,
+                                         UINT count) = 0;
+};
+
+HRESULT D3D11On12CreateDevice
+  (IUnknown* device, UINT flags, const D3D_FEATURE_LEVEL* featureLevels,
+   UINT featureLevelCount, IUnknown* const* queues, UINT queueCount,
+   UINT nodeMask, ID3D11Device** device11, ID3D11DeviceContext** context,
+   D3D_FEATURE_LEVEL* featureLevel);
@@ -0,0 +1,124 @@
+// Stand-in for the Windows SDK header on Linux (tests and benchmarks only)
+// Only the members used by the plugin. The values are the ones of the SDK.
+#pragma once
+
+#include <dxgi.h>
+
+typedef enum D3D12_RESOURCE_STATES
+{
+    D3D12_RESOURCE_STATE_COMMON = 0,
+    D3D12_RESOURCE_STATE_PRESENT = 0,
+    D3D12_RESOURCE_STATE_COPY_DEST = 0x400,
+    D3D12_RESOURCE_STATE_COPY_SOURCE = 0x800
+} D3D12_RESOURCE_STATES;
+
+typedef enum D3D12_RESOURCE_DIMENSION
+{
+    D3D12_RESOURCE_DIMENSION_UNKNOWN = 0,
+    D3D12_RESOURCE_DIMENSION_TEXTURE2D = 3
+} D3D12_RESOURCE_DIMENSION;
+
+typedef enum D3D12_TEXTURE_LAYOUT
+{
+    D3D12_TEXTURE_LAYOUT_UNKNOWN = 0
+} D3D12_TEXTURE_LAYOUT;
+
+typedef enum D3D12_RESOURCE_FLAGS
+{
+    D3D12_RESOURCE_FLAG_NONE = 0
+} D3D12_RESOURCE_FLAGS;
+
+typedef struct D3D12_RESOURCE_DESC
+{
+    D3D12_RESOURCE_DIMENSION Dimension;
+    UINT64 Alignment;
+    UINT64 Width;
+    UINT Height;
+    UINT16 DepthOrArraySize;
+    UINT16 MipLevels;
+    DXGI_FORMAT Format;
+    DXGI_SAMPLE_DESC SampleDesc;
+    D3D12_TEXTURE_LAYOUT Layout;
+    D3D12_RESOURCE_FLAGS Flags;
+} D3D12_RESOURCE_DESC;
+
+typedef enum D3D12_COMMAND_LIST_TYPE
+{
+    D3D12_COMMAND_LIST_TYPE_DIRECT = 0
+} D3D12_COMMAND_LIST_TYPE;
+
+typedef enum D3D12_RESOURCE_BARRIER_TYPE
+{
+    D3D12_RESOURCE_BARRIER_TYPE_TRANSITION = 0
+} D3D12_RESOURCE_BARRIER_TYPE;
+
+typedef enum D3D12_RESOURCE_BARRIER_FLAGS
+{
+    D3D12_RESOURCE_BARRIER_FLAG_NONE = 0
+} D3D12_RESOURCE_BARRIER_FLAGS;
+
+#define D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES 0xffffffff
+
+struct ID3D12Resource;
+
+typedef struct D3D12_RESOURCE_TRANSITION_BARRIER
+{
+    ID3D12Resource* pResource;
+    UINT Subresource;
+    D3D12_RESOURCE_STATES StateBefore;
+    D3D12_RESOURCE_STATES StateAfter;
+} D3D12_RESOURCE_TRANSITION_BARRIER;
+
+typedef struct D3D12_RESOURCE_BARRIER
+{
+    D3D12_RESOURCE_BARRIER_TYPE Type;
+    D3D12_RESOURCE_BARRIER_FLAGS Flags;
+    union
+    {
+        D3D12_RESOURCE_TRANSITION_BARRIER Transition;
+    };
+} D3D12_RESOURCE_BARRIER;
+
+struct ID3D12Resource : IUnknown
+{
+    virtual D3D12_RESOURCE_DESC GetDesc() = 0;
+};
+
+struct ID3D12Fence : IUnknown
+{
+    virtual UINT64 GetCompletedValue() = 0;
+};
+
+struct ID3D12PipelineState : IUnknown {};
+struct ID3D12CommandQueue : IUnknown {};
+
+struct ID3D12CommandAllocator : IUnknown
+{
+    virtual HRESULT Reset() = 0;
+};
+
+struct ID3D12CommandList : IUnknown {};
+
+struct ID3D12GraphicsCommandList : ID3D12CommandList
+{
+    virtual HRESULT Close() = 0;
+    virtual HRESULT Reset(ID3D12CommandAllocator* allocator,
+                          ID3D12PipelineState* state) = 0;
+    virtual void CopyResource(ID3D12Resource* dest,
+                              ID3D12Resource* source) = 0;
+    virtual void ResourceBarrier(UINT count,
+                                 const D3D12_RESOURCE_BARRIER* barriers) = 0;
+};
+
+struct ID3D12Device : IUnknown
+{
+    virtual HRESULT CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE type,
+                                           REFIID riid, void** allocator) = 0;
+    virtual HRESULT CreateCommandList(UINT nodeMask,
+                                      D3D12_COMMAND_LIST_TYPE type,
+                                      ID3D12CommandAllocator* allocator,
+                                      ID3D12PipelineState* state,
+                                      REFIID riid, void** list) = 0;
+    virtual HRESULT OpenSharedHandle(HANDLE handle, REFIID riid,
+                                     void** object) = 0;
+};
@@ -0,0 +1,19 @@
+// Stand-in for the Windows SDK header on Linux (tests and benchmarks only)
+// Only the members used by the plugin.
+#pragma once
+
+#include <unknwn.h>
+#include <dxgiformat.h>
+
+#define DXGI_ERROR_WAS_STILL_DRAWING ((HRESULT)0x887A000AL)
+
+typedef struct DXGI_SAMPLE_DESC
+{
+    UINT Count;
+    UINT Quality;
+} DXGI_SAMPLE_DESC;
+
+struct IDXGIResource : IUnknown
+{
+    virtual HRESULT GetSharedHandle(HANDLE* handle) = 0;
+};
@@ -0,0 +1,7 @@
+// Stand-in for the Windows SDK header on Linux (tests and benchmarks only)
+#pragma once
+
+#include <stdlib.h>
+
+inline void* CoTaskMemAlloc(size_t size) { return malloc(size); }
+inline void CoTaskMemFree(void* p) { free(p); }
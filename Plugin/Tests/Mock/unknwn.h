@@ -0,0 +1,50 @@
+// Stand-in for the Windows SDK header on Linux (tests and benchmarks only)
+// COM basics for the mock Direct3D headers. The interface IDs are plain
+// addresses, one per interface type. The implementations are in
+// Tests/MockDevice.h.
+#pragma once
+
+#include "Spout/SpoutPosix.h"
+
+typedef LONG HRESULT;
+typedef unsigned long ULONG;
+typedef int BOOL;
+typedef int INT;
+typedef uint16_t UINT16;
+typedef uint32_t UINT32;
+typedef uint64_t UINT64;
+
+#define S_OK ((HRESULT)0)
+#define S_FALSE ((HRESULT)1)
+#define E_NOINTERFACE ((HRESULT)0x80004002L)
+#define E_POINTER ((HRESULT)0x80004003L)
+#define E_FAIL ((HRESULT)0x80004005L)
+#define E_INVALIDARG ((HRESULT)0x80070057L)
+
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+
+typedef const void* REFIID;
+
+template <typename T>
+struct MockInterfaceId { static inline const char value = 0; };
+
+template <typename T>
+inline REFIID MockIIDOf(T**) { return &MockInterfaceId<T>::value; }
+
+template <typename T>
+inline void** MockPPVOf(T** pp) { return reinterpret_cast<void**>(pp); }
+
+#define IID_PPV_ARGS(pp) MockIIDOf(pp), MockPPVOf(pp)
+
+struct IUnknown
+{
+    virtual HRESULT QueryInterface(REFIID riid, void** object) = 0;
+    virtual ULONG AddRef() = 0;
+    virtual ULONG Release() = 0;
+};
+
+// Thread priority (the sweeper thread of the plugin), ignored
+#define THREAD_PRIORITY_LOWEST (-2)
+inline HANDLE GetCurrentThread() { return nullptr; }
+inline BOOL SetThreadPriority(HANDLE, int) { return 1; }
@@ -0,0 +1,123 @@
+// Stand-in for the Windows SDK header on Linux (tests and benchmarks only)
+// ComPtr with the members used by the plugin. As in the SDK, the address-of
+// operator returns a ComPtrRef, which releases the current object when it's
+// converted for an output argument and gives the ComPtr itself otherwise.
+#pragma once
+
+#include <unknwn.h>
+#include <cstddef>
+#include <utility>
+
+namespace Microsoft {
+namespace WRL {
+
+template <typename T>
+class ComPtr;
+
+template <typename P>
+class ComPtrRef
+{
+public:
+
+    explicit ComPtrRef(P* p) : _p(p) {}
+
+    operator P* () const { return _p; }
+    operator typename P::InterfaceType** () const
+      { return _p->ReleaseAndGetAddressOf(); }
+    operator void** () const
+      { return reinterpret_cast<void**>(_p->ReleaseAndGetAddressOf()); }
+
+private:
+
+    P* _p;
+};
+
+template <typename T>
+class ComPtr
+{
+public:
+
+    typedef T InterfaceType;
+
+    ComPtr() = default;
+    ComPtr(std::nullptr_t) {}
+    ComPtr(T* p) : _p(p) { if (_p) _p->AddRef(); }
+    ComPtr(const ComPtr& other) : ComPtr(other._p) {}
+    ComPtr(ComPtr&& other) noexcept : _p(other._p) { other._p = nullptr; }
+
+    template <typename U>
+    ComPtr(const ComPtr<U>& other) : ComPtr(other.Get()) {}
+
+    ~ComPtr() { if (_p) _p->Release(); }
+
+    ComPtr& operator = (ComPtr other)
+    {
+        std::swap(_p, other._p);
+        return *this;
+    }
+
+    T* Get() const { return _p; }
+    T* operator -> () const { return _p; }
+    explicit operator bool () const { return _p != nullptr; }
+
+    T* const* GetAddressOf() const { return &_p; }
+    T** GetAddressOf() { return &_p; }
+
+    T** ReleaseAndGetAddressOf()
+    {
+        Reset();
+        return &_p;
+    }
+
+    ComPtrRef<ComPtr> operator & () { return ComPtrRef<ComPtr>(this); }
+
+    void Reset()
+    {
+        if (_p) _p->Release();
+        _p = nullptr;
+    }
+
+    template <typename U>
+    HRESULT As(U** p) const
+    {
+        if (!_p) return E_POINTER;
+        return _p->QueryInterface(MockIIDOf(p), reinterpret_cast<void**>(p));
+    }
+
+    template <typename U>
+    HRESULT As(ComPtr<U>* p) const { return As(p->ReleaseAndGetAddressOf()); }
+
+    template <typename U>
+    HRESULT As(ComPtrRef<ComPtr<U>> p) const { return As(static_cast<ComPtr<U>*>(p)); }
+
+private:
+
+    T* _p = nullptr;
+};
+
+template <typename T, typename U>
+bool operator == (const ComPtr<T>& a, const ComPtr<U>& b)
+  { return a.Get() == b.Get(); }
+
+template <typename T, typename U>
+bool operator != (const ComPtr<T>& a, const ComPtr<U>& b)
+  { return a.Get() != b.Get(); }
+
+template <typename T>
+bool operator == (const ComPtr<T>& a, std::nullptr_t) { return !a; }
+
+template <typename T>
+bool operator != (const ComPtr<T>& a, std::nullptr_t) { return !!a; }
+
+} // namespace WRL
+} // namespace Microsoft
+
+// IID_PPV_ARGS(&comPtr)
+
+template <typename T>
+inline REFIID MockIIDOf(Microsoft::WRL::ComPtrRef<Microsoft::WRL::ComPtr<T>>)
+  { return &MockInterfaceId<T>::value; }
+
+template <typename T>
+inline void** MockPPVOf(Microsoft::WRL::ComPtrRef<Microsoft::WRL::ComPtr<T>> p)
+  { return p; }
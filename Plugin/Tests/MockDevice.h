@@ -0,0 +1,782 @@
+// Headless Direct3D 11/12 devices and Unity graphics interfaces for the
+// plugin tests (built against the headers in Tests/Mock)
+//
+// Textures are byte arrays. The GPU is a timeline of work values : an
+// executed copy stamps its destination with a new work value, which is
+// complete right away unless Gpu::hold is set, in which case it completes
+// on Gpu::complete. Map with D3D11_MAP_FLAG_DO_NOT_WAIT fails on a texture
+// with an incomplete write, as it does on a real device.
+//
+// D3D11 immediate contexts execute copies when they're recorded. D3D11On12
+// contexts only execute them on Flush, and D3D12 command lists on
+// ExecuteCommandList, which returns the work value as the fence value. An
+// event query ends with the work issued before it, so GetData reports it
+// done once that work is complete (and, on D3D11On12, flushed).
+// Share handles are process-wide, so a test can open the textures of a
+// sender as a receiver in another process would.
+//
+// Misuse that a debug layer would report (a copy between textures of a
+// different size, a copy into a texture that isn't in the copy destination
+// state, a reset of a command allocator that is still in flight) is counted
+// in Gpu::errors.
+//
+// Render thread only, as the plugin uses the devices.
+
+#pragma once
+
+#include <d3d11on12.h>
+#include <wrl/client.h>
+#include "Unity/IUnityGraphics.h"
+#include "Unity/IUnityGraphicsD3D11.h"
+#include "Unity/IUnityGraphicsD3D12.h"
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace MockD3D {
+
+using Microsoft::WRL::ComPtr;
+
+struct Surface
+{
+    D3D11_TEXTURE2D_DESC desc;
+    std::vector<uint8_t> data;
+    uint64_t work = 0; // Work value of the last write
+    D3D12_RESOURCE_STATES state = D3D12_RESOURCE_STATE_COMMON;
+};
+
+struct Gpu
+{
+    uint64_t issued = 0, completed = 0;
+    bool hold = false;
+
+    bool failOpen12 = false; // D3D12 OpenSharedHandle fails
+
+    // Counters
+    int copies = 0;     // Executed copies
+    int flushes = 0;    // D3D11 context flushes
+    int executions = 0; // ExecuteCommandList calls
+    int wraps = 0;      // CreateWrappedResource calls
+    int opens = 0;      // Shared handle opens (D3D11 and D3D12)
+    int textures = 0;   // Created textures
+    int errors = 0;
+
+    std::map<HANDLE, std::weak_ptr<Surface>> shared;
+    LONG nextHandle = 0x1000;
+
+    uint64_t issue()
+    {
+        issued++;
+        if (!hold) completed = issued;
+        return issued;
+    }
+
+    void complete() { completed = issued; }
+
+    bool isComplete(const Surface& surface) const
+      { return surface.work <= completed; }
+
+    void resetCounters()
+      { copies = flushes = executions = wraps = opens = textures = errors = 0; }
+};
+
+inline Gpu gpu;
+
+inline UINT BytesPerPixel(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+        case DXGI_FORMAT_R32G32B32A32_TYPELESS:
+        case DXGI_FORMAT_R32G32B32A32_FLOAT: return 16;
+        case DXGI_FORMAT_R16G16B16A16_TYPELESS:
+        case DXGI_FORMAT_R16G16B16A16_FLOAT: return 8;
+        default: return 4;
+    }
+}
+
+inline std::shared_ptr<Surface> NewSurface(const D3D11_TEXTURE2D_DESC& desc)
+{
+    auto surface = std::make_shared<Surface>();
+    surface->desc = desc;
+    surface->data.resize((size_t)desc.Width * desc.Height
+                         * BytesPerPixel(desc.Format));
+    gpu.textures++;
+    return surface;
+}
+
+inline void Execute(Surface& dest, const Surface& source)
+{
+    if (dest.desc.Width != source.desc.Width ||
+        dest.desc.Height != source.desc.Height ||
+        dest.data.size() != source.data.size())
+    {
+        gpu.errors++;
+        return;
+    }
+    dest.data = source.data;
+    dest.work = gpu.issue();
+    gpu.copies++;
+}
+
+template <typename T>
+inline bool Is(REFIID riid) { return riid == &MockInterfaceId<T>::value; }
+
+// Reference counting and QueryInterface for the given interfaces
+template <typename Derived, typename... Interfaces>
+class Object : public Interfaces...
+{
+public:
+
+    virtual ~Object() = default;
+
+    HRESULT QueryInterface(REFIID riid, void** object) override
+    {
+        *object = nullptr;
+        if (!static_cast<Derived*>(this)->query(riid, object))
+            return E_NOINTERFACE;
+        AddRef();
+        return S_OK;
+    }
+
+    ULONG AddRef() override { return ++_references; }
+
+    ULONG Release() override
+    {
+        auto count = --_references;
+        if (count == 0) delete this;
+        return count;
+    }
+
+private:
+
+    std::atomic<ULONG> _references { 1 };
+};
+
+// Textures and resources : views of a surface
+struct SurfaceView
+{
+    virtual ~SurfaceView() = default;
+    std::shared_ptr<Surface> surface;
+};
+
+inline Surface* SurfaceOf(IUnknown* object)
+{
+    auto view = dynamic_cast<SurfaceView*>(object);
+    return view ? view->surface.get() : nullptr;
+}
+
+class Texture11 final
+  : public Object<Texture11, ID3D11Texture2D, IDXGIResource>,
+    public SurfaceView
+{
+public:
+
+    HANDLE handle = nullptr;
+
+    bool query(REFIID riid, void** object)
+    {
+        if (Is<IUnknown>(riid) || Is<ID3D11Resource>(riid) ||
+            Is<ID3D11Texture2D>(riid))
+            *object = static_cast<ID3D11Texture2D*>(this);
+        else if (Is<IDXGIResource>(riid))
+            *object = static_cast<IDXGIResource*>(this);
+        return *object != nullptr;
+    }
+
+    void GetDesc(D3D11_TEXTURE2D_DESC* desc) override
+      { *desc = surface->desc; }
+
+    HRESULT GetSharedHandle(HANDLE* out) override
+    {
+        *out = handle;
+        return handle ? S_OK : E_INVALIDARG;
+    }
+};
+
+class Resource12 final
+  : public Object<Resource12, ID3D12Resource>, public SurfaceView
+{
+public:
+
+    bool query(REFIID riid, void** object)
+    {
+        if (Is<IUnknown>(riid) || Is<ID3D12Resource>(riid))
+            *object = static_cast<ID3D12Resource*>(this);
+        return *object != nullptr;
+    }
+
+    D3D12_RESOURCE_DESC GetDesc() override
+    {
+        D3D12_RESOURCE_DESC desc = {};
+        desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+        desc.Width = surface->desc.Width;
+        desc.Height = surface->desc.Height;
+        desc.DepthOrArraySize = 1;
+        desc.MipLevels = 1;
+        desc.Format = surface->desc.Format;
+        desc.SampleDesc.Count = 1;
+        return desc;
+    }
+};
+
+// New object owned by the returned pointer
+template <typename T, typename... Args>
+inline ComPtr<T> New(Args... args)
+{
+    ComPtr<T> object(new T(args...));
+    object->Release();
+    return object;
+}
+
+template <typename View>
+inline View* NewView(const std::shared_ptr<Surface>& surface)
+{
+    auto view = new View();
+    view->surface = surface;
+    return view;
+}
+
+inline std::shared_ptr<Surface> FindShared(HANDLE handle)
+{
+    auto it = gpu.shared.find(handle);
+    return it != gpu.shared.end() ? it->second.lock() : nullptr;
+}
+
+// D3D11 event query
+class Query11 final : public Object<Query11, ID3D11Query>
+{
+public:
+
+    bool ended = false;
+    uint64_t work = 0; // Work issued before the end
+
+    bool query(REFIID riid, void** object)
+    {
+        if (Is<IUnknown>(riid) || Is<ID3D11Asynchronous>(riid) ||
+            Is<ID3D11Query>(riid))
+            *object = static_cast<ID3D11Query*>(this);
+        return *object != nullptr;
+    }
+};
+
+// D3D11 device context
+// A deferred one (D3D11On12) executes the copies and ends the queries on
+// Flush.
+class Context11 final : public Object<Context11, ID3D11DeviceContext>
+{
+public:
+
+    explicit Context11(bool deferred) : _deferred(deferred) {}
+
+    ~Context11()
+    {
+        for (auto& op : _pending) if (op.query) op.query->Release();
+    }
+
+    bool query(REFIID riid, void** object)
+    {
+        if (Is<IUnknown>(riid) || Is<ID3D11DeviceContext>(riid))
+            *object = static_cast<ID3D11DeviceContext*>(this);
+        return *object != nullptr;
+    }
+
+    void CopyResource(ID3D11Resource* dest, ID3D11Resource* source) override
+    {
+        auto d = SurfaceOf(dest), s = SurfaceOf(source);
+        if (!d || !s) { gpu.errors++; return; }
+        if (_deferred)
+            _pending.push_back({d, s, nullptr});
+        else
+            Execute(*d, *s);
+    }
+
+    void End(ID3D11Asynchronous* async) override
+    {
+        auto query = static_cast<Query11*>(async);
+        query->ended = false;
+        if (_deferred)
+        {
+            query->AddRef();
+            _pending.push_back({nullptr, nullptr, query});
+        }
+        else
+        {
+            end(query);
+        }
+    }
+
+    HRESULT GetData(ID3D11Asynchronous* async, void*, UINT, UINT) override
+    {
+        auto query = static_cast<Query11*>(async);
+        if (query->ended && query->work <= gpu.completed) return S_OK;
+        return S_FALSE;
+    }
+
+    HRESULT Map(ID3D11Resource* resource, UINT, D3D11_MAP, UINT flags,
+                D3D11_MAPPED_SUBRESOURCE* mapped) override
+    {
+        auto surface = SurfaceOf(resource);
+        if (!surface || !(surface->desc.CPUAccessFlags & D3D11_CPU_ACCESS_READ))
+        {
+            gpu.errors++;
+            return E_INVALIDARG;
+        }
+
+        if (!gpu.isComplete(*surface))
+        {
+            if (flags & D3D11_MAP_FLAG_DO_NOT_WAIT)
+                return DXGI_ERROR_WAS_STILL_DRAWING;
+            gpu.complete();
+        }
+
+        // Rows padded to 256 bytes as on most drivers
+        auto row = surface->desc.Width * BytesPerPixel(surface->desc.Format);
+        auto pitch = (row + 255) & ~255u;
+        _mapped.assign((size_t)pitch * surface->desc.Height, 0xcd);
+        for (UINT y = 0; y < surface->desc.Height; y++)
+            std::copy_n(&surface->data[(size_t)y * row], row,
+                        &_mapped[(size_t)y * pitch]);
+
+        mapped->pData = _mapped.data();
+        mapped->RowPitch = pitch;
+        mapped->DepthPitch = pitch * surface->desc.Height;
+        return S_OK;
+    }
+
+    void Unmap(ID3D11Resource*, UINT) override {}
+
+    void Flush() override
+    {
+        gpu.flushes++;
+        for (auto& op : _pending)
+        {
+            if (op.query)
+            {
+                end(op.query);
+                op.query->Release();
+            }
+            else
+            {
+                Execute(*op.dest, *op.source);
+            }
+        }
+        _pending.clear();
+    }
+
+private:
+
+    struct Operation
+    {
+        Surface* dest;
+        Surface* source;
+        Query11* query;
+    };
+
+    bool _deferred;
+    std::vector<Operation> _pending;
+    std::vector<uint8_t> _mapped;
+
+    static void end(Query11* query)
+    {
+        query->ended = true;
+        query->work = gpu.issued;
+    }
+};
+
+// D3D11 device, also a D3D11On12 device if "on12" is set
+class Device11 final
+  : public Object<Device11, ID3D11Device, ID3D11On12Device>
+{
+public:
+
+    explicit Device11(bool on12)
+      : _on12(on12), _context(New<Context11>(on12)) {}
+
+    bool query(REFIID riid, void** object)
+    {
+        if (Is<IUnknown>(riid) || Is<ID3D11Device>(riid))
+            *object = static_cast<ID3D11Device*>(this);
+        else if (_on12 && Is<ID3D11On12Device>(riid))
+            *object = static_cast<ID3D11On12Device*>(this);
+        return *object != nullptr;
+    }
+
+    // ID3D11Device
+
+    HRESULT CreateTexture2D(const D3D11_TEXTURE2D_DESC* desc,
+                            const D3D11_SUBRESOURCE_DATA*,
+                            ID3D11Texture2D** texture) override
+    {
+        auto view = NewView<Texture11>(NewSurface(*desc));
+        if (desc->MiscFlags & D3D11_RESOURCE_MISC_SHARED)
+        {
+            view->handle = LongToHandle(gpu.nextHandle += 4);
+            gpu.shared[view->handle] = view->surface;
+        }
+        *texture = view;
+        return S_OK;
+    }
+
+    HRESULT OpenSharedResource(HANDLE handle, REFIID riid,
+                               void** resource) override
+    {
+        *resource = nullptr;
+        auto surface = FindShared(handle);
+        if (!surface) return E_INVALIDARG;
+        gpu.opens++;
+        ComPtr<Texture11> view(NewView<Texture11>(surface));
+        view->Release(); // Owned by the ComPtr
+        view->handle = handle;
+        return view->QueryInterface(riid, resource);
+    }
+
+    HRESULT CreateQuery(const D3D11_QUERY_DESC*, ID3D11Query** query) override
+    {
+        *query = new Query11();
+        return S_OK;
+    }
+
+    void GetImmediateContext(ID3D11DeviceContext** context) override
+    {
+        _context->AddRef();
+        *context = _context.Get();
+    }
+
+    // ID3D11On12Device
+
+    HRESULT CreateWrappedResource(IUnknown* resource12,
+                                  const D3D11_RESOURCE_FLAGS*,
+                                  D3D12_RESOURCE_STATES,
+                                  D3D12_RESOURCE_STATES,
+                                  REFIID riid, void** resource11) override
+    {
+        *resource11 = nullptr;
+        auto surface = dynamic_cast<SurfaceView*>(resource12);
+        if (!surface) return E_INVALIDARG;
+        gpu.wraps++;
+        ComPtr<Texture11> view(NewView<Texture11>(surface->surface));
+        view->Release();
+        return view->QueryInterface(riid, resource11);
+    }
+
+    void ReleaseWrappedResources(ID3D11Resource* const*, UINT) override {}
+    void AcquireWrappedResources(ID3D11Resource* const*, UINT) override {}
+
+private:
+
+    bool _on12;
+    ComPtr<Context11> _context;
+};
+
+// D3D12 command allocator : in flight until the work of its last
+// execution is complete
+class Allocator12 final
+  : public Object<Allocator12, ID3D12CommandAllocator>
+{
+public:
+
+    uint64_t work = 0;
+
+    bool query(REFIID riid, void** object)
+    {
+        if (Is<IUnknown>(riid) || Is<ID3D12CommandAllocator>(riid))
+            *object = static_cast<ID3D12CommandAllocator*>(this);
+        return *object != nullptr;
+    }
+
+    HRESULT Reset() override
+    {
+        if (work > gpu.completed) gpu.errors++;
+        return S_OK;
+    }
+};
+
+class CommandList12 final
+  : public Object<CommandList12, ID3D12GraphicsCommandList>
+{
+public:
+
+    bool query(REFIID riid, void** object)
+    {
+        if (Is<IUnknown>(riid) || Is<ID3D12CommandList>(riid) ||
+            Is<ID3D12GraphicsCommandList>(riid))
+            *object = static_cast<ID3D12GraphicsCommandList*>(this);
+        return *object != nullptr;
+    }
+
+    void begin(ID3D12CommandAllocator* allocator)
+    {
+        _allocator = static_cast<Allocator12*>(allocator);
+        _recording = true;
+        _copies.clear();
+        _states.clear();
+    }
+
+    HRESULT Close() override
+    {
+        if (!_recording) gpu.errors++;
+        _recording = false;
+        return S_OK;
+    }
+
+    HRESULT Reset(ID3D12CommandAllocator* allocator,
+                  ID3D12PipelineState*) override
+    {
+        if (_recording) gpu.errors++;
+        begin(allocator);
+        return S_OK;
+    }
+
+    void CopyResource(ID3D12Resource* dest, ID3D12Resource* source) override
+    {
+        auto d = SurfaceOf(dest), s = SurfaceOf(source);
+        if (!_recording || !d || !s) { gpu.errors++; return; }
+        if (state(d) != D3D12_RESOURCE_STATE_COPY_DEST) gpu.errors++;
+        _copies.push_back({d, s});
+    }
+
+    void ResourceBarrier(UINT count,
+                         const D3D12_RESOURCE_BARRIER* barriers) override
+    {
+        for (UINT i = 0; i < count; i++)
+        {
+            auto& t = barriers[i].Transition;
+            auto surface = SurfaceOf(t.pResource);
+            if (!surface || state(surface) != t.StateBefore) gpu.errors++;
+            if (surface) _states[surface] = t.StateAfter;
+        }
+    }
+
+    // ExecuteCommandList
+    uint64_t execute()
+    {
+        if (_recording) gpu.errors++;
+        for (auto& copy : _copies) Execute(*copy.first, *copy.second);
+        for (auto& s : _states) s.first->state = s.second;
+        auto work = gpu.issue();
+        if (_allocator) _allocator->work = work;
+        gpu.executions++;
+        return work;
+    }
+
+private:
+
+    Allocator12* _allocator = nullptr;
+    bool _recording = false;
+    std::vector<std::pair<Surface*, Surface*>> _copies;
+    std::map<Surface*, D3D12_RESOURCE_STATES> _states;
+
+    D3D12_RESOURCE_STATES state(Surface* surface)
+    {
+        auto it = _states.find(surface);
+        return it != _states.end() ? it->second : surface->state;
+    }
+};
+
+class Device12 final : public Object<Device12, ID3D12Device>
+{
+public:
+
+    bool query(REFIID riid, void** object)
+    {
+        if (Is<IUnknown>(riid) || Is<ID3D12Device>(riid))
+            *object = static_cast<ID3D12Device*>(this);
+        return *object != nullptr;
+    }
+
+    HRESULT CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE, REFIID riid,
+                                   void** allocator) override
+    {
+        return New<Allocator12>()->QueryInterface(riid, allocator);
+    }
+
+    HRESULT CreateCommandList(UINT, D3D12_COMMAND_LIST_TYPE,
+                              ID3D12CommandAllocator* allocator,
+                              ID3D12PipelineState*, REFIID riid,
+                              void** list) override
+    {
+        auto object = New<CommandList12>();
+        object->begin(allocator);
+        return object->QueryInterface(riid, list);
+    }
+
+    HRESULT OpenSharedHandle(HANDLE handle, REFIID riid,
+                             void** object) override
+    {
+        *object = nullptr;
+        auto surface = FindShared(handle);
+        if (!surface || gpu.failOpen12) return E_INVALIDARG;
+        gpu.opens++;
+        ComPtr<Resource12> view(NewView<Resource12>(surface));
+        view->Release();
+        return view->QueryInterface(riid, object);
+    }
+};
+
+class Fence12 final : public Object<Fence12, ID3D12Fence>
+{
+public:
+
+    bool query(REFIID riid, void** object)
+    {
+        if (Is<IUnknown>(riid) || Is<ID3D12Fence>(riid))
+            *object = static_cast<ID3D12Fence*>(this);
+        return *object != nullptr;
+    }
+
+    UINT64 GetCompletedValue() override { return gpu.completed; }
+};
+
+class Queue12 final : public Object<Queue12, ID3D12CommandQueue>
+{
+public:
+
+    bool query(REFIID riid, void** object)
+    {
+        if (Is<IUnknown>(riid) || Is<ID3D12CommandQueue>(riid))
+            *object = static_cast<ID3D12CommandQueue*>(this);
+        return *object != nullptr;
+    }
+};
+
+// Unity graphics interfaces with D3D11 or D3D12 devices
+// Only one instance at a time (the interface functions have no context).
+class Unity
+{
+public:
+
+    explicit Unity(UnityGfxRenderer renderer) : _renderer(renderer)
+    {
+        _current = this;
+
+        _interfaces.GetInterface = GetInterface;
+        _graphics.GetRenderer = GetRenderer;
+        _graphics.RegisterDeviceEventCallback = RegisterCallback;
+        _graphics.UnregisterDeviceEventCallback = UnregisterCallback;
+        _d3d11.GetDevice = GetDevice11;
+        _d3d12.GetDevice = GetDevice12;
+        _d3d12.GetFrameFence = GetFrameFence;
+        _d3d12.GetNextFrameFenceValue = GetNextFrameFenceValue;
+        _d3d12.ExecuteCommandList = ExecuteCommandList;
+        _d3d12.GetCommandQueue = GetCommandQueue;
+
+        _device11 = New<Device11>(false);
+        _device12 = New<Device12>();
+        _fence = New<Fence12>();
+        _queue = New<Queue12>();
+    }
+
+    ~Unity() { _current = nullptr; }
+
+    IUnityInterfaces* interfaces() { return &_interfaces; }
+
+    // Device event sent to the plugin (e.g. kUnityGfxDeviceEventShutdown)
+    void sendDeviceEvent(UnityGfxDeviceEventType type)
+      { if (_callback) _callback(type); }
+
+    // Texture rendered by Unity (see Fill)
+    IUnknown* createSource(UINT width, UINT height, DXGI_FORMAT format)
+    {
+        D3D11_TEXTURE2D_DESC desc = {};
+        desc.Width = width;
+        desc.Height = height;
+        desc.MipLevels = desc.ArraySize = desc.SampleDesc.Count = 1;
+        desc.Format = format;
+        auto surface = NewSurface(desc);
+        ComPtr<IUnknown> source;
+        if (_renderer == kUnityGfxRendererD3D12)
+            source = static_cast<ID3D12Resource*>(NewView<Resource12>(surface));
+        else
+            source = static_cast<ID3D11Texture2D*>(NewView<Texture11>(surface));
+        source->Release();
+        _sources.push_back(source);
+        return source.Get();
+    }
+
+private:
+
+    inline static Unity* _current;
+
+    UnityGfxRenderer _renderer;
+    IUnityGraphicsDeviceEventCallback _callback = nullptr;
+
+    IUnityInterfaces _interfaces = {};
+    IUnityGraphics _graphics = {};
+    IUnityGraphicsD3D11 _d3d11 = {};
+    IUnityGraphicsD3D12v6 _d3d12 = {};
+
+    ComPtr<Device11> _device11;
+    ComPtr<Device12> _device12;
+    ComPtr<Fence12> _fence;
+    ComPtr<Queue12> _queue;
+    std::vector<ComPtr<IUnknown>> _sources;
+
+    static IUnityInterface* GetInterface(UnityInterfaceGUID guid)
+    {
+        if (guid == GetUnityInterfaceGUID<IUnityGraphics>())
+            return &_current->_graphics;
+        if (guid == GetUnityInterfaceGUID<IUnityGraphicsD3D11>())
+            return &_current->_d3d11;
+        if (guid == GetUnityInterfaceGUID<IUnityGraphicsD3D12v6>())
+            return &_current->_d3d12;
+        return nullptr;
+    }
+
+    static UnityGfxRenderer GetRenderer() { return _current->_renderer; }
+
+    static void RegisterCallback(IUnityGraphicsDeviceEventCallback callback)
+      { _current->_callback = callback; }
+
+    static void UnregisterCallback(IUnityGraphicsDeviceEventCallback)
+      { _current->_callback = nullptr; }
+
+    static ID3D11Device* GetDevice11() { return _current->_device11.Get(); }
+    static ID3D12Device* GetDevice12() { return _current->_device12.Get(); }
+    static ID3D12Fence* GetFrameFence() { return _current->_fence.Get(); }
+    static UINT64 GetNextFrameFenceValue() { return gpu.issued + 1; }
+
+    static ID3D12CommandQueue* GetCommandQueue()
+      { return _current->_queue.Get(); }
+
+    static UINT64 ExecuteCommandList
+      (ID3D12GraphicsCommandList* list, int, UnityGraphicsD3D12ResourceState*)
+    {
+        return static_cast<CommandList12*>(list)->execute();
+    }
+};
+
+// CPU access to the contents of a texture, as if rendered or sampled
+inline void Fill(IUnknown* texture, uint8_t value)
+{
+    auto surface = SurfaceOf(texture);
+    std::fill(surface->data.begin(), surface->data.end(), value);
+}
+
+// Value of all the bytes of a texture (-1 if they differ)
+inline int ValueOf(const Surface* surface)
+{
+    if (!surface || surface->data.empty()) return -1;
+    auto value = surface->data[0];
+    for (auto b : surface->data) if (b != value) return -1;
+    return value;
+}
+
+inline int ValueOf(IUnknown* texture) { return ValueOf(SurfaceOf(texture)); }
+
+// Value of the texture of a share handle
+inline int ValueOf(HANDLE handle) { return ValueOf(FindShared(handle).get()); }
+
+} // namespace MockD3D
+
+HRESULT D3D11On12CreateDevice
+  (IUnknown*, UINT, const D3D_FEATURE_LEVEL*, UINT, IUnknown* const*, UINT,
+   UINT, ID3D11Device** device11, ID3D11DeviceContext** context,
+   D3D_FEATURE_LEVEL*)
+{
+    auto device = new MockD3D::Device11(true);
+    device->GetImmediateContext(context);
+    *device11 = device;
+    return S_OK;
+}
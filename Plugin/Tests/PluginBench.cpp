@@ -0,0 +1,290 @@
+// Per call cost of the hot paths of the plugin, by sender count and
+// sender name length : the sender set buffer conversions, the sender
+// info reads, the name marshaling, the disabled log calls and the format
+// conversions. Format.h and Util.h are built against the headers in
+// Tests/Mock.
+//
+// Usage : PluginBench [--senders 8,64,256] [--name-length 16,64]
+//                     [--duration seconds] [--json output]
+//                     [--baseline input] [--threshold percent]
+//
+// --json writes the results, --baseline compares them with a previous
+// --json output and fails when a call is slower by more than the
+// threshold (default 20 %).
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+#include "Format.h"
+#include "Util.h"
+
+namespace {
+
+using namespace KlakSpout;
+
+volatile uintptr_t Sink; // Keeps the results of the measured calls
+
+double Duration = 0.2; // seconds per measurement
+
+struct Result
+{
+    std::string name;
+    int senders, nameLength;
+    double ns;
+};
+
+class Registry : public spoutSenderNames
+{
+public:
+
+    Registry() { SetDeferredCleanup(true); }
+
+    using spoutSenderNames::readSenderSetFromBuffer;
+    using spoutSenderNames::writeBufferFromSenderSet;
+};
+
+// Nanoseconds per call of a function
+template <typename Function>
+double Measure(Function func)
+{
+    func(); // warm-up
+    uint64_t start = SpoutTest::Nanoseconds();
+    uint64_t end = start + (uint64_t)(Duration * 1e9);
+    uint64_t calls = 0, now;
+    do
+    {
+        for (int i = 0; i < 16; i++) func();
+        calls += 16;
+        now = SpoutTest::Nanoseconds();
+    }
+    while (now < end);
+    return (double)(now - start) / (double)calls;
+}
+
+std::vector<int> ParseList(const char* arg)
+{
+    std::vector<int> list;
+    for (const char* p = arg; *p; )
+    {
+        list.push_back(atoi(p));
+        p = strchr(p, ',');
+        if (!p) break;
+        p++;
+    }
+    return list;
+}
+
+// Sender name of the given length, padded after the index
+std::string SenderName(int index, int length)
+{
+    char prefix[32];
+    snprintf(prefix, sizeof(prefix), "Sender %04d ", index);
+    std::string name = prefix;
+    name.resize(std::max(length, (int)name.size()), 'x');
+    return name;
+}
+
+void RunSenders(std::vector<Result>& results, int senders, int nameLength)
+{
+    char ns[32];
+    snprintf(ns, sizeof(ns), "pbench%d_%d_", senders, nameLength);
+    SpoutTest::UseNamespace(ns);
+
+    std::vector<std::string> names;
+    std::set<std::string> set;
+    for (int i = 0; i < senders; i++)
+    {
+        names.push_back(SenderName(i, nameLength));
+        set.insert(names.back());
+    }
+
+    auto add = [&](const char* name, double ns)
+    {
+        results.push_back({ name, senders, nameLength, ns });
+    };
+
+    // Sender set buffer conversions, per whole set
+    std::vector<char> buffer((size_t)senders * SpoutMaxSenderNameLen);
+    Registry::writeBufferFromSenderSet(set, buffer.data(), senders);
+    add("readSenderSetFromBuffer", Measure([&] {
+        std::set<std::string> read;
+        Registry::readSenderSetFromBuffer(buffer.data(), read, senders);
+        Sink = read.size();
+    }));
+    add("writeBufferFromSenderSet", Measure([&] {
+        Registry::writeBufferFromSenderSet(set, buffer.data(), senders);
+        Sink = buffer[0];
+    }));
+
+    // Sender info reads, per sender
+    Registry sender, receiver;
+    sender.SetMaxSenders(senders);
+    receiver.SetMaxSenders(senders);
+    for (int i = 0; i < senders; i++)
+        CHECK(sender.CreateSender(names[i].c_str(), 64, 64, LongToHandle(i + 1), 87));
+
+    size_t next = 0;
+    SharedTextureInfo info;
+    add("getSharedInfo", Measure([&] {
+        receiver.getSharedInfo(names[next].c_str(), &info);
+        Sink = info.width;
+        next = (next + 1) % names.size();
+    }));
+    add("CheckSender", Measure([&] {
+        unsigned int width, height;
+        HANDLE handle;
+        DWORD format;
+        Sink = receiver.CheckSender(names[next].c_str(), width, height, handle, format);
+        next = (next + 1) % names.size();
+    }));
+
+    // Name marshaling, per whole set
+    SpoutSenderNameTable table;
+    for (auto& name : names) table.Insert(name.c_str());
+    add("MarshalStringSet", Measure([&] {
+        auto pair = MarshalStringSet(&table);
+        for (auto i = 0; i < pair.second; i++) CoTaskMemFree(pair.first[i]);
+        CoTaskMemFree(pair.first);
+        Sink = pair.second;
+    }));
+
+    for (auto& name : names) sender.ReleaseSenderName(name.c_str());
+    SpoutTest::RemoveNamespace();
+}
+
+void RunCommon(std::vector<Result>& results)
+{
+    auto add = [&](const char* name, double ns)
+    {
+        results.push_back({ name, 0, 0, ns });
+    };
+
+    // Logging disabled : _doLog returns before formatting
+    add("_doLog", Measure([&] {
+        SpoutLogNotice("spoutSenderNames::CheckSender - [%s] %dx%d", "Sender", 1920, 1080);
+    }));
+
+    // Format conversions, per loop over all the DXGI values
+    add("ToFormat", Measure([&] {
+        int sum = 0;
+        for (int f = 0; f < 120; f++) sum += (int)ToFormat((DXGI_FORMAT)f);
+        Sink = sum;
+    }));
+    add("ToDXGIFormat", Measure([&] {
+        int sum = 0;
+        for (int f = 0; f <= (int)Format::RGBAFloat; f++) sum += ToDXGIFormat((Format)f);
+        Sink = sum;
+    }));
+    add("NegotiateFormat", Measure([&] {
+        int sum = 0;
+        for (int r = 0; r <= (int)Format::RGBAFloat; r++)
+            for (int f = 0; f < 120; f++)
+                sum += NegotiateFormat((Format)r, (DXGI_FORMAT)f);
+        Sink = sum;
+    }));
+}
+
+bool WriteJson(const char* path, const std::vector<Result>& results)
+{
+    FILE* file = fopen(path, "w");
+    if (!file) return false;
+    fprintf(file, "{\"benchmarks\":[\n");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        auto& r = results[i];
+        fprintf(file, "{\"name\":\"%s\",\"senders\":%d,\"nameLength\":%d,\"ns\":%.1f}%s\n",
+                r.name.c_str(), r.senders, r.nameLength, r.ns,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(file, "]}\n");
+    fclose(file);
+    return true;
+}
+
+// Reads the output of WriteJson (one result per line)
+bool ReadJson(const char* path, std::vector<Result>& results)
+{
+    FILE* file = fopen(path, "r");
+    if (!file) return false;
+    char line[512], name[128];
+    Result r;
+    while (fgets(line, sizeof(line), file))
+    {
+        if (sscanf(line, "{\"name\":\"%127[^\"]\",\"senders\":%d,\"nameLength\":%d,\"ns\":%lf",
+                   name, &r.senders, &r.nameLength, &r.ns) != 4) continue;
+        r.name = name;
+        results.push_back(r);
+    }
+    fclose(file);
+    return true;
+}
+
+// Number of results slower than the baseline by more than the threshold
+int CompareBaseline(const std::vector<Result>& results,
+                    const std::vector<Result>& baseline, double threshold)
+{
+    int regressions = 0;
+    for (auto& r : results)
+    {
+        for (auto& b : baseline)
+        {
+            if (b.name != r.name || b.senders != r.senders || b.nameLength != r.nameLength)
+                continue;
+            double change = (r.ns / b.ns - 1) * 100;
+            if (change > threshold)
+            {
+                printf("regression : %-26s %4d senders %3d chars %10.1f ns (baseline %.1f, +%.0f %%)\n",
+                       r.name.c_str(), r.senders, r.nameLength, r.ns, b.ns, change);
+                regressions++;
+            }
+        }
+    }
+    return regressions;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    std::vector<int> senderCounts = { 8, 64, 256 };
+    std::vector<int> nameLengths = { 16, 64 };
+    const char* jsonPath = nullptr;
+    const char* baselinePath = nullptr;
+    double threshold = 20;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--senders") == 0) senderCounts = ParseList(argv[i + 1]);
+        else if (strcmp(argv[i], "--name-length") == 0) nameLengths = ParseList(argv[i + 1]);
+        else if (strcmp(argv[i], "--duration") == 0) Duration = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "--json") == 0) jsonPath = argv[i + 1];
+        else if (strcmp(argv[i], "--baseline") == 0) baselinePath = argv[i + 1];
+        else if (strcmp(argv[i], "--threshold") == 0) threshold = atof(argv[i + 1]);
+    }
+
+    std::vector<Result> results;
+    RunCommon(results);
+    for (int senders : senderCounts)
+    {
+        for (int length : nameLengths)
+        {
+            // Names have to fit in a slot with the terminator
+            if (senders < 1 || length < 1 || length >= SpoutMaxSenderNameLen) continue;
+            RunSenders(results, senders, length);
+        }
+    }
+
+    for (auto& r : results)
+        printf("%-26s %4d senders %3d chars %10.1f ns\n",
+               r.name.c_str(), r.senders, r.nameLength, r.ns);
+
+    if (jsonPath) CHECK(WriteJson(jsonPath, results));
+
+    if (baselinePath)
+    {
+        std::vector<Result> baseline;
+        if (CHECK(ReadJson(baselinePath, baseline)))
+            CHECK(CompareBaseline(results, baseline, threshold) == 0);
+    }
+
+    return SpoutTest::Finish("PluginBench");
+}
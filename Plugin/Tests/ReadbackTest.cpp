@@ -0,0 +1,288 @@
+// ReadbackRing on the mock device (D3D11, and D3D12 through D3D11On12) :
+// the slots rotate, the published frames are (depth - 1) frames late with
+// stamps that only increase and contents that match their stamps, also
+// while the GPU is behind, the source handle changes or a reader thread
+// reads all the time. GetReceiverReadback copies the frame without the
+// plugin lock.
+
+#include "Test.h"
+#include "MockDevice.h"
+#include "Plugin.cpp"
+#include <signal.h>
+#include <sys/mman.h>
+#include <thread>
+
+namespace {
+
+const UINT Width = 16, Height = 8;
+const int Depth = 3;
+
+struct SharedTexture
+{
+    WRL::ComPtr<ID3D11Texture2D> texture;
+    HANDLE handle;
+};
+
+SharedTexture CreateShared(UINT width, UINT height)
+{
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = width;
+    desc.Height = height;
+    desc.MipLevels = desc.ArraySize = desc.SampleDesc.Count = 1;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.MiscFlags = D3D11_RESOURCE_MISC_SHARED;
+
+    SharedTexture shared = {};
+    _system->getD3D11Device()->CreateTexture2D(&desc, nullptr, &shared.texture);
+    WRL::ComPtr<IDXGIResource> resource;
+    shared.texture.As(&resource);
+    resource->GetSharedHandle(&shared.handle);
+    return shared;
+}
+
+// All the bytes of a frame hold the stamp (mod 256)
+bool Matches(const std::vector<uint8_t>& buffer, int size, uint64_t stamp)
+{
+    for (int i = 0; i < size; i++)
+        if (buffer[i] != (uint8_t)stamp) return false;
+    return size > 0;
+}
+
+void RunRing(const char* label, UnityGfxRenderer renderer)
+{
+    MockD3D::Unity unity(renderer);
+    _system = std::make_unique<System>(unity.interfaces());
+    MockD3D::gpu = {};
+
+    // Two slots of a multi-buffered sender, and a resized texture
+    auto slotA = CreateShared(Width, Height);
+    auto slotB = CreateShared(Width, Height);
+    auto resized = CreateShared(Width * 2, Height);
+
+    auto ring = std::make_unique<ReadbackRing>(Depth);
+    std::vector<uint8_t> buffer(Width * 2 * Height * 4);
+
+    const int HoldStart = 20, HoldEnd = 26, Resize = 40, Frames = 60;
+
+    uint64_t last = 0;
+    int published = 0, mismatches = 0, regressions = 0, late = 0;
+    int textures = 0;
+
+    for (int frame = 1; frame <= Frames; frame++)
+    {
+        // The GPU falls behind for a few frames.
+        MockD3D::gpu.hold = frame >= HoldStart && frame < HoldEnd;
+        if (frame == HoldEnd) MockD3D::gpu.complete();
+
+        auto& source = frame >= Resize ? resized : (frame & 1 ? slotA : slotB);
+        MockD3D::Fill(source.texture.Get(), (uint8_t)frame);
+        ring->copy(source.handle);
+
+        if (frame == Depth) textures = MockD3D::gpu.textures;
+
+        ReadbackInfo info;
+        auto size = ring->read(buffer.data(), (int)buffer.size(), info);
+        if (info.stamp == 0) continue;
+
+        // A copy is made every frame, so the stamp is the frame number.
+        if (info.stamp < last) regressions++;
+        if (info.stamp > last) published++;
+        if (!Matches(buffer, size, info.stamp)) mismatches++;
+        if (size != (int)(info.rowPitch * info.height)) mismatches++;
+
+        // Not waiting for the GPU, so (depth - 1) frames late
+        auto held = frame >= HoldStart && frame < HoldEnd;
+        auto settled = frame < Resize || frame >= Resize + Depth - 1;
+        if (!held && settled && info.stamp != (uint64_t)(frame - Depth + 1))
+            late++;
+
+        last = info.stamp;
+    }
+
+    ReadbackInfo info;
+    ring->read(nullptr, 0, info);
+
+    printf("ReadbackTest (%s) : %d frames published of %d, last %llu (%ux%u), "
+           "%d mismatches, %d opens, %d GPU errors\n", label, published,
+           Frames, (unsigned long long)last, info.width, info.height,
+           mismatches, MockD3D::gpu.opens, MockD3D::gpu.errors);
+
+    CHECK(mismatches == 0);
+    CHECK(regressions == 0);
+    CHECK(late == 0);
+    // Frames dropped while the GPU was behind
+    CHECK(published < Frames - Depth + 1);
+    CHECK(published > Frames / 2);
+    CHECK(last == (uint64_t)(Frames - Depth + 1));
+    CHECK(info.width == Width * 2 && info.rowPitch == Width * 2 * 4);
+    // The two slots of the same size share the staging textures and the
+    // sources are opened once.
+    CHECK(MockD3D::gpu.textures == textures + Depth);
+    CHECK(MockD3D::gpu.opens == 3);
+    CHECK(MockD3D::gpu.errors == 0);
+
+    // Sender gone : The last frame stays readable.
+    ring->copy(nullptr);
+    ring->read(buffer.data(), (int)buffer.size(), info);
+    CHECK(info.stamp == last);
+
+    ring.reset();
+    _system.reset();
+}
+
+// A reader thread reads all the time while the frames are copied.
+void RunConcurrentReader()
+{
+    MockD3D::Unity unity(kUnityGfxRendererD3D11);
+    _system = std::make_unique<System>(unity.interfaces());
+    MockD3D::gpu = {};
+
+    auto source = CreateShared(Width, Height);
+    auto ring = std::make_shared<ReadbackRing>(Depth);
+
+    std::atomic<bool> stop { false };
+    std::atomic<int> reads { 0 }, mismatches { 0 }, regressions { 0 };
+
+    std::thread reader([&]()
+    {
+        std::vector<uint8_t> buffer(Width * Height * 4);
+        uint64_t last = 0;
+        while (!stop)
+        {
+            ReadbackInfo info;
+            auto size = ring->read(buffer.data(), (int)buffer.size(), info);
+            if (info.stamp == 0) continue;
+            if (!Matches(buffer, size, info.stamp)) mismatches++;
+            if (info.stamp < last) regressions++;
+            last = info.stamp;
+            reads++;
+        }
+    });
+
+    const int Frames = 5000;
+    for (int frame = 1; frame <= Frames; frame++)
+    {
+        MockD3D::Fill(source.texture.Get(), (uint8_t)frame);
+        ring->copy(source.handle);
+        if (frame % 16 == 0) std::this_thread::yield();
+    }
+
+    stop = true;
+    reader.join();
+
+    printf("ReadbackTest (reader thread) : %d reads, %d mismatches\n",
+           reads.load(), mismatches.load());
+
+    CHECK(reads > 0);
+    CHECK(mismatches == 0);
+    CHECK(regressions == 0);
+
+    ring.reset();
+    _system.reset();
+}
+
+// GetReceiverReadback into a buffer that faults on the first write : the
+// fault handler checks that the plugin lock is free during the copy.
+std::atomic<int> faults { 0 };
+std::atomic<bool> lockFree { false };
+void* guarded = nullptr;
+
+void OnFault(int, siginfo_t*, void*)
+{
+    faults++;
+    if (lock_.try_lock())
+    {
+        lockFree = true;
+        lock_.unlock();
+    }
+    mprotect(guarded, 4096, PROT_READ | PROT_WRITE);
+}
+
+void RunPlugin()
+{
+    MockD3D::Unity unity(kUnityGfxRendererD3D11);
+    MockD3D::gpu = {};
+    UnityPluginLoad(unity.interfaces());
+    auto event = GetRenderEventCallback();
+
+    auto source = unity.createSource(Width, Height, DXGI_FORMAT_R8G8B8A8_UNORM);
+    auto sender = CreateSender("Readback", Width, Height, Format::RGBA32, 1);
+    auto receiver = CreateReceiver("Readback");
+    SetReceiverReadback(receiver, Depth);
+
+    EventData senderData = {}, receiverData = {}, none = {};
+    senderData.sender = sender;
+    senderData.texture = source;
+    receiverData.receiver = receiver;
+
+    // Frames until the readback has one (the poller finds the sender)
+    std::vector<uint8_t> buffer(Width * Height * 4);
+    ReadbackInfo info = {};
+    int frame = 0;
+    for (; frame < 2000 && info.stamp == 0; frame++)
+    {
+        MockD3D::Fill(source, (uint8_t)(frame + 1));
+        event(event_updateSender, &senderData);
+        event(event_flushSenders, &none);
+        event(event_updateAllReceivers, &none);
+        GetReceiverReadback(receiver, buffer.data(), (int)buffer.size(), &info);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    auto value = buffer[0];
+    CHECK(info.stamp > 0);
+    CHECK(info.width == Width && info.height == Height);
+    CHECK(Matches(buffer, (int)buffer.size(), value));
+    CHECK(value > 0 && value <= (uint8_t)frame);
+
+    // Copy into the guarded page
+    guarded = mmap(nullptr, 4096, PROT_NONE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    struct sigaction action = {}, previous;
+    action.sa_sigaction = OnFault;
+    action.sa_flags = SA_SIGINFO;
+    sigaction(SIGSEGV, &action, &previous);
+
+    auto size = GetReceiverReadback(receiver, guarded, 4096, &info);
+
+    sigaction(SIGSEGV, &previous, nullptr);
+
+    printf("ReadbackTest (plugin) : stamp %llu after %d frames, "
+           "%d faults, lock free during the copy %d\n",
+           (unsigned long long)info.stamp, frame, faults.load(),
+           lockFree.load());
+
+    CHECK(size == (int)(Width * Height * 4));
+    CHECK(faults == 1);
+    CHECK(lockFree);
+    munmap(guarded, 4096);
+
+    // Closed while a reader holds the ring : It stays readable.
+    std::shared_ptr<ReadbackRing> ring;
+    {
+        std::lock_guard<std::mutex> guard(lock_);
+        ring = receiver->getReadback();
+    }
+
+    event(event_closeReceiver, &receiverData);
+    event(event_closeSender, &senderData);
+
+    ReadbackInfo held;
+    CHECK(ring && ring->read(buffer.data(), (int)buffer.size(), held) > 0);
+    CHECK(held.stamp == info.stamp);
+    ring.reset();
+
+    UnityPluginUnload();
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("readback");
+    RunRing("D3D11", kUnityGfxRendererD3D11);
+    RunRing("D3D12", kUnityGfxRendererD3D12);
+    RunConcurrentReader();
+    RunPlugin();
+    return SpoutTest::Finish("ReadbackTest");
+}
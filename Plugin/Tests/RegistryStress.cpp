@@ -0,0 +1,268 @@
+// Multi-process registry churn stress harness (make stress)
+//
+// Forks worker processes that register, release, check, enumerate and
+// select senders against the shared registry, while the parent sweeps
+// orphans, validates the sender set and kills and restarts workers at
+// random. Reports the throughput, latency percentiles per call, lock
+// timeouts and invariant violations (duplicate or unordered names,
+// dangling active sender, names left after all the workers have ended).
+// Senders missing from the set right after their creation are reported
+// as well : CreateSender doesn't fail when the registration times out.
+//
+// Usage : RegistryStress [-p processes] [-d seconds] [-k kill interval ms]
+//         (-k 0 : no kills)
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+#include <math.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <thread>
+#include <vector>
+
+namespace {
+
+const int NamesPerWorker = 8;
+const int Buckets = 512; // Latency histogram, 8 buckets per octave of ns
+const SpoutLockPolicy WaitPolicy = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+
+enum Operation { OpCreate, OpRelease, OpCheck, OpEnumerate, OpActive, OpClean, OpCount };
+const char* OperationNames[OpCount] = { "create", "release", "check", "enumerate", "active", "clean" };
+
+// Results of a worker slot, in memory shared with the parent.
+// A restarted worker adds to the slot of the killed one.
+struct WorkerSlot
+{
+    uint64_t histogram[OpCount][Buckets];
+    uint64_t lockTimeouts;
+    uint64_t missing; // Own senders not in the set right after creation
+};
+
+struct Shared
+{
+    volatile int stop;
+    WorkerSlot workers[1]; // processes entries
+};
+
+int Bucket(uint64_t ns)
+{
+    if (ns < 1) return 0;
+    int b = (int)(log2((double)ns) * 8);
+    return b < Buckets ? b : Buckets - 1;
+}
+
+uint64_t BucketValue(int b)
+{
+    return (uint64_t)exp2((double)(b + 1) / 8);
+}
+
+uint64_t LockTimeouts()
+{
+    SpoutLockStatsData data[64];
+    int count = SpoutLockStats::Snapshot(data, 64);
+    uint64_t total = 0;
+    for (int i = 0; i < count && i < 64; i++) total += data[i].timeouts;
+    return total;
+}
+
+void RunWorker(Shared* shared, int index)
+{
+    WorkerSlot& slot = shared->workers[index];
+    uint64_t timeouts = slot.lockTimeouts;
+
+    srand((unsigned)(getpid() * 7919));
+    SpoutLockStats::Enable(true);
+
+    spoutSenderNames names;
+    bool registered[NamesPerWorker] = {};
+    char name[64], other[64];
+
+    for (uint64_t ops = 0; !shared->stop; ops++)
+    {
+        int k = rand() % NamesPerWorker;
+        snprintf(name, sizeof(name), "Worker %02d-%d", index, k);
+
+        int r = rand() % 100;
+        Operation op = r < 25 ? OpCreate : r < 50 ? OpRelease : r < 75 ? OpCheck
+                     : r < 90 ? OpEnumerate : r < 97 ? OpActive : OpClean;
+
+        uint64_t start = SpoutTest::Nanoseconds();
+
+        switch (op)
+        {
+        case OpCreate:
+            if (names.CreateSender(name, 64, 64, LongToHandle(index + 1)))
+            {
+                registered[k] = true;
+                SpoutSenderQuery query = {};
+                query.name = name;
+                names.CheckSenders(&query, 1, WaitPolicy);
+                if (query.result == SPOUT_CHECK_FAILED) slot.missing++;
+            }
+            break;
+        case OpRelease:
+            names.ReleaseSenderName(name);
+            registered[k] = false;
+            break;
+        case OpCheck:
+        {
+            // Senders of other workers, which may be gone
+            snprintf(other, sizeof(other), "Worker %02d-%d", rand() % 64, k);
+            unsigned int width, height;
+            HANDLE handle;
+            DWORD format;
+            names.CheckSender(other, width, height, handle, format);
+            break;
+        }
+        case OpEnumerate:
+            names.GetSenderCount();
+            break;
+        case OpActive:
+            if (registered[k]) names.SetActiveSender(name);
+            break;
+        default:
+            names.CleanSenders();
+            break;
+        }
+
+        slot.histogram[op][Bucket(SpoutTest::Nanoseconds() - start)]++;
+
+        if ((ops & 255) == 0) slot.lockTimeouts = timeouts + LockTimeouts();
+    }
+
+    slot.lockTimeouts = timeouts + LockTimeouts();
+
+    for (int k = 0; k < NamesPerWorker; k++)
+    {
+        snprintf(name, sizeof(name), "Worker %02d-%d", index, k);
+        if (registered[k]) names.ReleaseSenderName(name);
+    }
+}
+
+pid_t StartWorker(Shared* shared, int index)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        RunWorker(shared, index);
+        _exit(0);
+    }
+    return pid;
+}
+
+void PrintPercentiles(const char* label, const uint64_t* histogram, double seconds)
+{
+    uint64_t total = 0;
+    for (int b = 0; b < Buckets; b++) total += histogram[b];
+    if (total == 0) return;
+
+    uint64_t p50 = 0, p99 = 0, max = 0, sum = 0;
+    for (int b = 0; b < Buckets; b++)
+    {
+        if (!histogram[b]) continue;
+        sum += histogram[b];
+        if (!p50 && sum * 2 >= total) p50 = BucketValue(b);
+        if (!p99 && sum * 100 >= total * 99) p99 = BucketValue(b);
+        max = BucketValue(b);
+    }
+
+    printf("  %-10s %10.0f ops/s  p50 %8.1f us  p99 %8.1f us  max %9.1f us\n",
+           label, total / seconds, p50 * 1e-3, p99 * 1e-3, max * 1e-3);
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    int processes = 8;
+    double duration = 5;
+    int killInterval = 200;
+
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "-p") == 0) processes = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-d") == 0) duration = atof(argv[i + 1]);
+        else if (strcmp(argv[i], "-k") == 0) killInterval = atoi(argv[i + 1]);
+    }
+    if (processes < 1 || processes > 64) processes = 8;
+
+    SpoutTest::UseNamespace("stress");
+
+    size_t size = sizeof(Shared) + sizeof(WorkerSlot) * (processes - 1);
+    Shared* shared = (Shared*)mmap(NULL, size, PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (shared == MAP_FAILED) return 1;
+
+    printf("RegistryStress : %d processes, %.0f s, kill every %d ms\n",
+           processes, duration, killInterval);
+
+    std::vector<pid_t> workers(processes);
+    for (int i = 0; i < processes; i++) workers[i] = StartWorker(shared, i);
+
+    // Sweeper and validator
+    spoutSenderNames monitor;
+    monitor.SetDeferredCleanup(true);
+
+    srand(1);
+    uint64_t start = SpoutTest::Nanoseconds();
+    uint64_t end = start + (uint64_t)(duration * 1e9);
+    uint64_t nextKill = start + (uint64_t)killInterval * 1000000;
+    int kills = 0, sweeps = 0, swept = 0, violations = 0;
+
+    for (uint64_t now = start; now < end; now = SpoutTest::Nanoseconds())
+    {
+        swept += monitor.SweepOrphans(WaitPolicy);
+        violations += monitor.ValidateSenderSet();
+        sweeps++;
+
+        if (killInterval > 0 && now >= nextKill)
+        {
+            int i = rand() % processes;
+            kill(workers[i], SIGKILL);
+            waitpid(workers[i], nullptr, 0);
+            workers[i] = StartWorker(shared, i);
+            kills++;
+            nextKill = now + (uint64_t)killInterval * 1000000;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    double seconds = (SpoutTest::Nanoseconds() - start) * 1e-9;
+
+    shared->stop = 1;
+    for (pid_t pid : workers) waitpid(pid, nullptr, 0);
+
+    // The names of the killed workers are left for the sweep
+    for (int i = 0; i < 10 && monitor.GetSenderCount() > 0; i++)
+        swept += monitor.SweepOrphans(WaitPolicy);
+    int left = monitor.GetSenderCount();
+    violations += monitor.ValidateSenderSet();
+
+    uint64_t total[OpCount][Buckets] = {};
+    uint64_t timeouts = 0, missing = 0;
+    for (int i = 0; i < processes; i++)
+    {
+        for (int op = 0; op < OpCount; op++)
+            for (int b = 0; b < Buckets; b++)
+                total[op][b] += shared->workers[i].histogram[op][b];
+        timeouts += shared->workers[i].lockTimeouts;
+        missing += shared->workers[i].missing;
+    }
+
+    for (int op = 0; op < OpCount; op++)
+        PrintPercentiles(OperationNames[op], total[op], seconds);
+
+    printf("  %d kills, %d sweeps, %d names swept\n", kills, sweeps, swept);
+    printf("  lock timeouts %llu, invariant violations %d, "
+           "missing senders %llu, names left %d\n",
+           (unsigned long long)timeouts, violations,
+           (unsigned long long)missing, left);
+
+    CHECK(violations == 0);
+    CHECK(left == 0);
+
+    munmap(shared, size);
+
+    return SpoutTest::Finish("RegistryStress");
+}
@@ -0,0 +1,43 @@
+// Sender registry on the POSIX backend : create, find, check and release
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+
+int main()
+{
+    SpoutTest::UseNamespace("registry");
+
+    spoutSenderNames sender, receiver;
+
+    CHECK(sender.CreateSender("Alpha", 640, 360, LongToHandle(0x1234), 87));
+    CHECK(sender.CreateSender("Beta", 1920, 1080, LongToHandle(0x5678), 28));
+
+    CHECK(receiver.FindSenderName("Alpha"));
+    CHECK(receiver.FindSenderName("Beta"));
+    CHECK(!receiver.FindSenderName("Gamma"));
+    CHECK(receiver.GetSenderCount() == 2);
+
+    std::set<std::string> names;
+    CHECK(receiver.GetSenderNames(&names));
+    CHECK(names == (std::set<std::string>{ "Alpha", "Beta" }));
+
+    unsigned int width = 0, height = 0;
+    HANDLE handle = nullptr;
+    DWORD format = 0;
+    CHECK(receiver.CheckSender("Beta", width, height, handle, format));
+    CHECK(width == 1920 && height == 1080 && format == 28);
+    CHECK(HandleToLong(handle) == 0x5678);
+
+    CHECK(sender.UpdateSender("Beta", 1280, 720, LongToHandle(0x9abc), 28));
+    CHECK(receiver.CheckSender("Beta", width, height, handle, format));
+    CHECK(width == 1280 && height == 720 && HandleToLong(handle) == 0x9abc);
+
+    CHECK(sender.ReleaseSenderName("Alpha"));
+    CHECK(!receiver.FindSenderName("Alpha"));
+    CHECK(!receiver.CheckSender("Alpha", width, height, handle, format));
+    CHECK(receiver.GetSenderCount() == 1);
+
+    CHECK(receiver.ValidateSenderSet() == 0);
+
+    return SpoutTest::Finish("RegistryTest");
+}
@@ -0,0 +1,132 @@
+// Sender set extension segments : a first map smaller than MaxSenders,
+// the slots left for legacy applications, and segments that are read
+// whether the first map is full or not
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+#include <thread>
+
+namespace {
+
+// Names are registered without senders, so they are not removed as
+// orphans by the sender checks.
+class Registry : public spoutSenderNames
+{
+public:
+
+    Registry() { SetDeferredCleanup(true); }
+
+    using spoutSenderNames::readSenderSetFromBuffer;
+    using spoutSenderNames::writeBufferFromSenderSet;
+
+    // Read and write the first map as a legacy application of the
+    // given number of senders does
+    std::set<std::string> legacyRead(int maxSenders)
+    {
+        std::set<std::string> names;
+        char* buf = m_senderNames.Lock();
+        readSenderSetFromBuffer(buf, names, maxSenders);
+        m_senderNames.Unlock();
+        return names;
+    }
+
+    void legacyWrite(const std::set<std::string>& names, int maxSenders)
+    {
+        char* buf = m_senderNames.Lock();
+        writeBufferFromSenderSet(names, buf, maxSenders);
+        m_senderNames.Unlock();
+    }
+};
+
+void WaitForRevalidation()
+{
+    std::this_thread::sleep_for
+      (std::chrono::milliseconds(SpoutSenderSetRevalidateTime + 50));
+}
+
+} // namespace
+
+int main()
+{
+    char name[64];
+
+    // First map created by a 10 sender application
+    {
+        SpoutTest::UseNamespace("segment10_");
+
+        SpoutSharedMemory legacyMap;
+        CHECK(legacyMap.Create("SpoutSenderNames", 10 * SpoutMaxSenderNameLen)
+              == SPOUT_CREATE_SUCCESS);
+
+        Registry registry;
+        registry.SetMaxSenders(64);
+        for (int i = 0; i < 40; i++)
+        {
+            snprintf(name, sizeof(name), "Sender %02d", i);
+            CHECK(registry.RegisterSenderName(name));
+        }
+
+        // 9 names in the first map (one slot left), the rest in a segment
+        std::set<std::string> first = registry.legacyRead(10);
+        CHECK(first.size() == 9);
+        CHECK(registry.GetSenderCount() == 40);
+        CHECK(registry.ValidateSenderSet() == 0);
+
+        Registry other;
+        CHECK(other.FindSenderName("Sender 39"));
+        CHECK(other.FindSenderName("Sender 00"));
+
+        SpoutTest::RemoveNamespace();
+    }
+
+    // Legacy registration and release with the segments in use
+    {
+        SpoutTest::UseNamespace("segment64_");
+
+        Registry registry, receiver;
+        for (int i = 0; i < 100; i++)
+        {
+            snprintf(name, sizeof(name), "Sender %03d", i);
+            CHECK(registry.RegisterSenderName(name));
+        }
+        CHECK(receiver.FindSenderName("Sender 099"));
+
+        // A legacy application of 64 senders finds room in the first map
+        std::set<std::string> first = registry.legacyRead(64);
+        CHECK(first.size() == 56);
+        first.insert("Legacy");
+        registry.legacyWrite(first, 64);
+        CHECK(registry.legacyRead(64).size() == 57);
+
+        WaitForRevalidation();
+        CHECK(receiver.FindSenderName("Legacy"));
+        CHECK(receiver.FindSenderName("Sender 099"));
+
+        // The first map is no longer full after a legacy release :
+        // the segment names are still seen
+        first.erase("Legacy");
+        first.erase("Sender 000");
+        registry.legacyWrite(first, 64);
+
+        WaitForRevalidation();
+        CHECK(!receiver.FindSenderName("Legacy"));
+        CHECK(!receiver.FindSenderName("Sender 000"));
+        CHECK(receiver.FindSenderName("Sender 099"));
+        CHECK(receiver.GetSenderCount() == 99);
+
+        // Releases move the names back to the first map
+        for (int i = 1; i < 60; i++)
+        {
+            snprintf(name, sizeof(name), "Sender %03d", i);
+            CHECK(registry.ReleaseSenderName(name));
+        }
+        CHECK(registry.legacyRead(64).size() == 40);
+        CHECK(receiver.FindSenderName("Sender 099"));
+        CHECK(receiver.GetSenderCount() == 40);
+        CHECK(registry.ValidateSenderSet() == 0);
+
+        SpoutTest::RemoveNamespace();
+    }
+
+    return SpoutTest::Finish("SegmentTest");
+}
@@ -0,0 +1,94 @@
+// Crashed sender detection while another receiver process keeps the
+// sender info map open (cached info maps, SweepOrphans)
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+#include <signal.h>
+#include <sys/wait.h>
+
+namespace {
+
+const SpoutLockPolicy WaitPolicy = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+
+void Signal(int fd) { char c = 1; (void)!write(fd, &c, 1); }
+void Wait(int fd) { char c; (void)!read(fd, &c, 1); }
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("liveness");
+
+    int senderReady[2], receiverReady[2];
+    (void)!pipe(senderReady);
+    (void)!pipe(receiverReady);
+
+    // Sender process, killed below
+    pid_t sender = fork();
+    if (sender == 0)
+    {
+        spoutSenderNames names;
+        names.CreateSender("Crashing", 64, 64, LongToHandle(1), 87);
+        Signal(senderReady[1]);
+        for (;;) pause();
+    }
+    Wait(senderReady[0]);
+
+    // Another receiver process polling the sender all the time
+    pid_t receiver = fork();
+    if (receiver == 0)
+    {
+        spoutSenderNames names;
+        names.SetDeferredCleanup(true);
+        unsigned int width, height;
+        HANDLE handle;
+        DWORD format;
+        bool first = true;
+        for (;;)
+        {
+            if (names.CheckSender("Crashing", width, height, handle, format) && first)
+            {
+                Signal(receiverReady[1]);
+                first = false;
+            }
+            usleep(1000);
+        }
+    }
+    Wait(receiverReady[0]);
+
+    spoutSenderNames names;
+    names.SetDeferredCleanup(true);
+
+    SpoutSenderQuery query = {};
+    query.name = "Crashing";
+    names.CheckSenders(&query, 1, WaitPolicy);
+    CHECK(query.result == SPOUT_CHECK_SUCCESS);
+    CHECK(query.stamp != 0);
+
+    // Nothing to sweep while the sender runs
+    CHECK(names.SweepOrphans(WaitPolicy) == 0);
+
+    kill(sender, SIGKILL);
+    waitpid(sender, nullptr, 0);
+
+    // The unchanged fast path has to give up within the check interval
+    int checks = 0;
+    do
+    {
+        names.CheckSenders(&query, 1, WaitPolicy);
+        checks++;
+    }
+    while (query.result != SPOUT_CHECK_FAILED && checks < 10 * SpoutInfoCacheReopenCount);
+    CHECK(query.result == SPOUT_CHECK_FAILED);
+    CHECK(checks <= SpoutInfoCacheReopenCount + 1);
+
+    // The name is reclaimed although the map is still open elsewhere
+    CHECK(names.FindSenderName("Crashing"));
+    CHECK(names.SweepOrphans(WaitPolicy) == 1);
+    CHECK(!names.FindSenderName("Crashing"));
+
+    kill(receiver, SIGKILL);
+    waitpid(receiver, nullptr, 0);
+
+    return SpoutTest::Finish("SenderLivenessTest");
+}
@@ -0,0 +1,125 @@
+// Multi-buffered senders on the mock devices (D3D11, D3D12 and D3D12 through
+// D3D11On12) : each frame is copied once, into a ring slot, and the slot is
+// published in the ring map and advertised in the sender info only once the
+// GPU has finished the copy. A slot held by a reader is never written.
+
+#include "Test.h"
+#include "MockDevice.h"
+#include "Plugin.cpp"
+
+namespace {
+
+const UINT Width = 32, Height = 16;
+const int Frames = 40, HoldStart = 10, HoldEnd = 15;
+
+HANDLE ToHandle(uint32_t handle)
+{
+    return LongToHandle(static_cast<LONG>(handle));
+}
+
+void Run(const char* label, UnityGfxRenderer renderer, bool failOpen12)
+{
+    MockD3D::Unity unity(renderer);
+    MockD3D::gpu = {};
+    MockD3D::gpu.failOpen12 = failOpen12;
+    UnityPluginLoad(unity.interfaces());
+    auto event = GetRenderEventCallback();
+
+    auto source = unity.createSource(Width, Height, DXGI_FORMAT_R8G8B8A8_UNORM);
+    EventData data = {}, none = {};
+    data.sender = CreateSender("Ring", Width, Height, Format::RGBA32, 2);
+    data.texture = source;
+
+    // First frame (lazy initialization)
+    MockD3D::Fill(source, 0);
+    event(event_updateSender, &data);
+    event(event_flushSenders, &none);
+
+    // Reader of the ring, as a receiver in another process
+    SpoutSharedMemory map;
+    CHECK(map.Open("Ring_ring"));
+    SpoutTextureRing ring;
+    ring.Attach(map.Buffer());
+    CHECK(ring.SlotCount() == 3);
+
+    int multiple = 0, missing = 0, overwritten = 0, early = 0;
+    int mismatches = 0, stale = 0;
+    int held = -1;
+    uint32_t epoch = 0;
+
+    for (int frame = 1; frame <= Frames; frame++)
+    {
+        // The GPU falls behind for a few frames.
+        auto holding = frame >= HoldStart && frame < HoldEnd;
+        MockD3D::gpu.hold = holding;
+        if (frame == HoldEnd) MockD3D::gpu.complete();
+
+        // Hold the latest slot over the frame.
+        auto previous = epoch;
+        auto slot = ring.AcquireLatest(epoch);
+        ring.Release(held, previous);
+        held = slot;
+        auto heldHandle = ToHandle(ring.Handle(held));
+        auto heldValue = MockD3D::ValueOf(heldHandle);
+
+        auto copies = MockD3D::gpu.copies;
+        MockD3D::Fill(source, (uint8_t)frame);
+        event(event_updateSender, &data);
+        event(event_flushSenders, &none);
+        copies = MockD3D::gpu.copies - copies;
+
+        // One copy per frame (none while all the slots are busy)
+        if (copies > 1) multiple++;
+        if (!holding && copies != 1) missing++;
+
+        if (MockD3D::ValueOf(heldHandle) != heldValue) overwritten++;
+
+        // The latest slot is advertised, and its copy is complete.
+        auto latest = ring.AcquireLatest(epoch);
+        auto handle = ToHandle(ring.Handle(latest));
+        ring.Release(latest, epoch);
+
+        unsigned int width, height;
+        HANDLE advertised;
+        DWORD format;
+        _system->spout.GetSenderInfo("Ring", width, height, advertised, format);
+        if (advertised != handle) mismatches++;
+
+        auto surface = MockD3D::FindShared(handle);
+        if (!surface || !MockD3D::gpu.isComplete(*surface)) early++;
+
+        // Held back while the GPU is behind, then the latest frame
+        auto value = MockD3D::ValueOf(handle);
+        if (holding ? value != HoldStart - 1 : value != frame) stale++;
+    }
+
+    ring.Release(held, epoch);
+
+    printf("SenderRingTest (%s) : %d copies in %d frames, %d frames with "
+           "more than one copy, %d overwritten, %d published early, "
+           "%d GPU errors\n", label, MockD3D::gpu.copies, Frames + 1,
+           multiple, overwritten, early, MockD3D::gpu.errors);
+
+    CHECK(multiple == 0);
+    CHECK(missing == 0);
+    CHECK(overwritten == 0);
+    CHECK(early == 0);
+    CHECK(mismatches == 0);
+    CHECK(stale == 0);
+    CHECK(MockD3D::gpu.errors == 0);
+
+    event(event_closeSender, &data);
+    unity.sendDeviceEvent(kUnityGfxDeviceEventShutdown);
+    UnityPluginUnload();
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("senderring");
+    Run("D3D11", kUnityGfxRendererD3D11, false);
+    Run("D3D12", kUnityGfxRendererD3D12, false);
+    Run("D3D11On12", kUnityGfxRendererD3D12, true);
+    return SpoutTest::Finish("SenderRingTest");
+}
@@ -0,0 +1,177 @@
+// Sender counters on the mock D3D12 device, read through the exported
+// functions. With the D3D11On12 fallback (the shared textures can't be opened
+// on the D3D12 device), a source is wrapped once and wrapped again only when
+// it changes, and the copies of all the senders are flushed once per frame,
+// so the frames reach the shared textures at the flush event (one frame
+// late). With the native path, there are no wraps or flushes, and each update
+// is submitted right away, so the frame is there after the update event.
+
+#include "Test.h"
+#include "MockDevice.h"
+#include "Plugin.cpp"
+
+namespace {
+
+const int Senders = 2, Frames = 20;
+const UINT Width = 32, Height = 16;
+
+struct Stream
+{
+    Sender* sender;
+    IUnknown* source;
+    EventData data;
+};
+
+// Value of the advertised texture of a sender
+int Advertised(size_t index)
+{
+    char name[64];
+    snprintf(name, sizeof(name), "Stats %zu", index);
+    unsigned int width, height;
+    HANDLE handle;
+    DWORD format;
+    _system->spout.GetSenderInfo(name, width, height, handle, format);
+    return MockD3D::ValueOf(handle);
+}
+
+// Frames of all the senders with the render events of the plugin
+// "immediate" counts the frames that are there right after the update
+// event, "mismatches" the ones that aren't there after the flush event.
+void RunFrames(std::vector<Stream>& streams, int first, int count,
+               int& immediate, int& mismatches)
+{
+    auto event = GetRenderEventCallback();
+    EventData none = {};
+    for (int frame = first; frame < first + count; frame++)
+    {
+        for (size_t i = 0; i < streams.size(); i++)
+        {
+            auto value = (uint8_t)(frame * Senders + i);
+            MockD3D::Fill(streams[i].source, value);
+            event(event_updateSender, &streams[i].data);
+            if (Advertised(i) == value) immediate++;
+        }
+
+        // Beginning of the next frame
+        event(event_flushSenders, &none);
+
+        for (size_t i = 0; i < streams.size(); i++)
+            if (Advertised(i) != (uint8_t)(frame * Senders + i)) mismatches++;
+    }
+}
+
+void Run(bool native)
+{
+    MockD3D::Unity unity(kUnityGfxRendererD3D12);
+    MockD3D::gpu = {};
+    MockD3D::gpu.failOpen12 = !native;
+    UnityPluginLoad(unity.interfaces());
+
+    std::vector<Stream> streams(Senders);
+    for (int i = 0; i < Senders; i++)
+    {
+        char name[64];
+        snprintf(name, sizeof(name), "Stats %d", i);
+        auto& s = streams[i];
+        s.sender = CreateSender(name, Width, Height, Format::RGBA32, 1);
+        s.source = unity.createSource(Width, Height, DXGI_FORMAT_R8G8B8A8_UNORM);
+        s.data = {};
+        s.data.sender = s.sender;
+        s.data.texture = s.source;
+    }
+
+    int immediate = 0, mismatches = 0;
+    RunFrames(streams, 1, Frames, immediate, mismatches);
+    auto stats = GetSenderStats();
+
+    // A new source object for the first sender (e.g. a recreated render
+    // texture) and a few more frames
+    streams[0].source = unity.createSource(Width, Height,
+                                           DXGI_FORMAT_R8G8B8A8_UNORM);
+    streams[0].data.texture = streams[0].source;
+    RunFrames(streams, Frames + 1, Frames, immediate, mismatches);
+    auto after = GetSenderStats();
+
+    printf("SenderStatsTest (%s) : %u frames, %u wraps, %u flushes, "
+           "%u submissions, %d of %d frames there after the update, "
+           "%d mismatches, %d GPU errors\n",
+           native ? "native" : "D3D11On12", after.frames,
+           after.wrapCreations, after.flushes, after.submissions,
+           immediate, Frames * 2 * Senders, mismatches, MockD3D::gpu.errors);
+
+    CHECK(stats.frames == (uint32_t)Frames);
+    CHECK(after.frames == (uint32_t)Frames * 2);
+    CHECK(mismatches == 0);
+    CHECK(MockD3D::gpu.errors == 0);
+
+    if (native)
+    {
+        CHECK(after.wrapCreations == 0 && MockD3D::gpu.wraps == 0);
+        CHECK(after.flushes == 0);
+        // One per update, with no frame of latency
+        CHECK(stats.submissions == (uint32_t)(Frames * Senders));
+        CHECK(after.submissions == (uint32_t)(Frames * 2 * Senders));
+        CHECK(MockD3D::gpu.executions == Frames * 2 * Senders);
+        CHECK(immediate == Frames * 2 * Senders);
+    }
+    else
+    {
+        // Once per source, not per frame
+        CHECK(stats.wrapCreations == (uint32_t)Senders);
+        CHECK(after.wrapCreations == (uint32_t)Senders + 1);
+        CHECK(MockD3D::gpu.wraps == Senders + 1);
+        // Once per frame, not per sender
+        CHECK(stats.flushes == (uint32_t)Frames);
+        CHECK(after.flushes == (uint32_t)Frames * 2);
+        CHECK(after.submissions == 0);
+        // Submitted at the flush event (one frame late)
+        CHECK(immediate == 0);
+    }
+
+    auto event = GetRenderEventCallback();
+    for (auto& s : streams) event(event_closeSender, &s.data);
+    unity.sendDeviceEvent(kUnityGfxDeviceEventShutdown);
+    UnityPluginUnload();
+}
+
+// Lock wait counters of the registry maps, through the exports
+void RunLockStats()
+{
+    MockD3D::Unity unity(kUnityGfxRendererD3D11);
+    UnityPluginLoad(unity.interfaces());
+    EnableLockStats(1);
+
+    auto source = unity.createSource(Width, Height, DXGI_FORMAT_R8G8B8A8_UNORM);
+    EventData data = {};
+    data.sender = CreateSender("Lock stats", Width, Height, Format::RGBA32, 1);
+    data.texture = source;
+    auto event = GetRenderEventCallback();
+    event(event_updateSender, &data);
+
+    std::vector<SpoutLockStatsData> entries(64);
+    auto count = GetLockStats(entries.data(), (int)entries.size());
+    uint64_t acquisitions = 0;
+    for (int i = 0; i < std::min(count, (int)entries.size()); i++)
+        acquisitions += entries[i].acquisitions;
+
+    printf("SenderStatsTest (lock stats) : %d maps, %llu acquisitions\n",
+           count, (unsigned long long)acquisitions);
+
+    CHECK(count > 0);
+    CHECK(acquisitions > 0);
+
+    EnableLockStats(0);
+    event(event_closeSender, &data);
+    UnityPluginUnload();
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("senderstats");
+    Run(false);
+    Run(true);
+    RunLockStats();
+    return SpoutTest::Finish("SenderStatsTest");
+}
@@ -0,0 +1,160 @@
+// Lock-free sender info reads (sequence word in SharedTextureInfo::usage)
+// Reader threads must never see a torn width/height/handle/format tuple,
+// neither with the sequence word nor with a legacy writer using the mutex.
+// Reports p50/p99/p999 read latency with and without a writer.
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+const int ReaderCount = 3;
+const double Duration = 0.3; // seconds per run
+
+// Tuple of a write number : every field is derived from it
+void MakeTuple(unsigned int k, unsigned int& width, unsigned int& height, HANDLE& handle, DWORD& format)
+{
+    width = k & 0x7fffff;
+    height = (width * 3 + 1) & 0x7fffff;
+    handle = LongToHandle((long)((width * 7) & 0x7fffffff));
+    format = width ^ 0xabcd;
+}
+
+bool IsConsistent(const SharedTextureInfo& info)
+{
+    unsigned int width, height;
+    HANDLE handle;
+    DWORD format;
+    MakeTuple(info.width, width, height, handle, format);
+    return info.height == height && info.shareHandle == (unsigned int)HandleToLong(handle) && info.format == format;
+}
+
+// Legacy writer : whole structure under the mutex, no sequence word
+void LegacyWrite(SpoutSharedMemory& map, unsigned int k)
+{
+    SharedTextureInfo info = {};
+    unsigned int width, height;
+    HANDLE handle;
+    DWORD format;
+    MakeTuple(k, width, height, handle, format);
+    info.width = width;
+    info.height = height;
+    info.shareHandle = (unsigned int)HandleToLong(handle);
+    info.format = format;
+    char* buf = map.Lock();
+    if (!buf) return;
+    memcpy(buf, &info, sizeof(info));
+    map.Unlock();
+}
+
+struct RunResult
+{
+    SpoutTest::Samples latency; // nsec
+    uint64_t reads = 0, torn = 0, failed = 0;
+};
+
+// Run readers against the map of "name" while write(k) is called in a loop
+template <typename Writer>
+RunResult Run(const char* name, bool contention, Writer write)
+{
+    std::atomic<bool> stop{false};
+    std::vector<RunResult> results(ReaderCount);
+    std::vector<std::thread> readers;
+
+    for (int r = 0; r < ReaderCount; r++)
+        readers.emplace_back([&, r] {
+            spoutSenderNames names;
+            RunResult& result = results[r];
+            SharedTextureInfo info;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                uint64_t start = SpoutTest::Nanoseconds();
+                bool ok = names.getSharedInfo(name, &info);
+                result.latency.add(SpoutTest::Nanoseconds() - start);
+                result.reads++;
+                if (!ok) result.failed++;
+                else if (!IsConsistent(info)) result.torn++;
+            }
+        });
+
+    uint64_t end = SpoutTest::Nanoseconds() + (uint64_t)(Duration * 1e9);
+    for (unsigned int k = 1; SpoutTest::Nanoseconds() < end; k++)
+    {
+        if (contention)
+            write(k);
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    stop = true;
+    for (auto& t : readers) t.join();
+
+    RunResult total;
+    for (RunResult& r : results)
+    {
+        total.reads += r.reads;
+        total.torn += r.torn;
+        total.failed += r.failed;
+        total.latency.merge(r.latency);
+    }
+    return total;
+}
+
+void Report(const char* label, RunResult& r)
+{
+    printf("  %-28s reads %9llu  p50 %6llu ns  p99 %7llu ns  p999 %8llu ns  torn %llu\n",
+           label, (unsigned long long)r.reads,
+           (unsigned long long)r.latency.percentile(0.5),
+           (unsigned long long)r.latency.percentile(0.99),
+           (unsigned long long)r.latency.percentile(0.999),
+           (unsigned long long)r.torn);
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("seqlock");
+
+    // Sender with the sequence word
+    spoutSenderNames sender;
+    unsigned int width, height;
+    HANDLE handle;
+    DWORD format;
+    MakeTuple(0, width, height, handle, format);
+    CHECK(sender.CreateSender("Seq", width, height, handle, format));
+
+    auto seqWrite = [&](unsigned int k) {
+        MakeTuple(k, width, height, handle, format);
+        sender.UpdateSender("Seq", width, height, handle, format);
+    };
+
+    // Legacy sender map written under the mutex only
+    SpoutSharedMemory legacy;
+    CHECK(legacy.Create("Legacy", sizeof(SharedTextureInfo)) == SPOUT_CREATE_SUCCESS);
+    LegacyWrite(legacy, 0);
+    auto legacyWrite = [&](unsigned int k) { LegacyWrite(legacy, k); };
+
+    printf("SeqlockTest (%d reader threads)\n", ReaderCount);
+
+    RunResult seqIdle = Run("Seq", false, seqWrite);
+    RunResult seqBusy = Run("Seq", true, seqWrite);
+    RunResult legacyIdle = Run("Legacy", false, legacyWrite);
+    RunResult legacyBusy = Run("Legacy", true, legacyWrite);
+
+    Report("sequence word, no writer", seqIdle);
+    Report("sequence word, writer", seqBusy);
+    Report("legacy mutex, no writer", legacyIdle);
+    Report("legacy mutex, writer", legacyBusy);
+
+    for (RunResult* r : { &seqIdle, &seqBusy, &legacyIdle, &legacyBusy })
+    {
+        CHECK(r->reads > 0);
+        CHECK(r->torn == 0);
+        CHECK(r->failed == 0);
+    }
+
+    return SpoutTest::Finish("SeqlockTest");
+}
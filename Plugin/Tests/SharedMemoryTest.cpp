@@ -0,0 +1,195 @@
+// POSIX shared memory backend : create/open semantics, lock recovery,
+// release of the attachments of crashed processes, and open/close/reopen
+// not waiting for the map mutex
+
+#include "Test.h"
+#include "Spout/SpoutSharedMemory.h"
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+namespace {
+
+// Check if the shared memory object of a map name exists
+bool Exists(const char* name)
+{
+    std::string path = "/";
+    path += getenv("SPOUT_SHM_NAMESPACE");
+    path += name;
+    int fd = shm_open(path.c_str(), O_RDONLY, 0);
+    if (fd < 0) return false;
+    close(fd);
+    return true;
+}
+
+// Run a function in a child process that exits without cleaning up
+template <typename Function>
+void RunChild(Function func)
+{
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        func();
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+}
+
+void TestCreateOpen()
+{
+    SpoutSharedMemory creator, reader;
+    CHECK(!reader.Open("map"));
+    CHECK(creator.Create("map", 256) == SPOUT_CREATE_SUCCESS);
+    CHECK(creator.Create("map", 256) == SPOUT_ALREADY_CREATED);
+    CHECK(reader.Open("map"));
+    CHECK(reader.Size() == 0);
+
+    SpoutSharedMemory second;
+    CHECK(second.Create("map", 256) == SPOUT_ALREADY_EXISTS);
+
+    char* buf = creator.Lock();
+    CHECK(buf != nullptr);
+    if (buf) strcpy(buf, "hello");
+    creator.Unlock();
+
+    buf = reader.Lock();
+    CHECK(buf && strcmp(buf, "hello") == 0);
+    reader.Unlock();
+
+    second.Close();
+    reader.Close();
+    CHECK(Exists("map"));
+    creator.Close();
+    CHECK(!Exists("map"));
+}
+
+void TestLockPolicies()
+{
+    SpoutSharedMemory a, b;
+    CHECK(a.Create("policy", 64) == SPOUT_CREATE_SUCCESS);
+    CHECK(b.Open("policy"));
+
+    CHECK(a.Lock() != nullptr);
+    CHECK(a.Lock() != nullptr); // re-entrant
+    CHECK(b.Lock(SpoutLockPolicy{ SPOUT_LOCK_TRY, 0, 0, 0 }) == nullptr);
+    CHECK(b.Lock(SpoutLockPolicy{ SPOUT_LOCK_SPIN, 4, 1, 0 }) == nullptr);
+    CHECK(b.Lock(SpoutLockPolicy{ SPOUT_LOCK_DEADLINE, 0, 0, 200 }) == nullptr);
+    a.Unlock();
+    a.Unlock();
+    CHECK(b.Lock(SpoutLockPolicy{ SPOUT_LOCK_TRY, 0, 0, 0 }) != nullptr);
+    b.Unlock();
+}
+
+// Open, Close and Reopen don't wait for a map held by another object,
+// as with the Win32 version (no blocking at all : the attachments have
+// a mutex of their own)
+void TestOpenWhileLocked()
+{
+    SpoutSharedMemory creator;
+    CHECK(creator.Create("held", 64) == SPOUT_CREATE_SUCCESS);
+    CHECK(creator.Lock() != nullptr);
+
+    long blocks = SpoutTest::Blocks();
+    for (int i = 0; i < 100; i++)
+    {
+        SpoutSharedMemory reader;
+        CHECK(reader.Open("held"));
+        CHECK(reader.Reopen());
+        reader.Close();
+    }
+    CHECK(SpoutTest::Blocks() == blocks);
+
+    creator.Unlock();
+
+    // Reopen fails once the other object is gone, and the segment with it
+    SpoutSharedMemory reader;
+    CHECK(reader.Open("held"));
+    creator.Close();
+    CHECK(Exists("held"));
+    CHECK(!reader.Reopen());
+    CHECK(!Exists("held"));
+    CHECK(reader.Buffer() == nullptr);
+}
+
+// A process crashing with the mutex held doesn't block the others,
+// and its attachment is released with the recovered mutex
+void TestCrashWhileLocked()
+{
+    SpoutSharedMemory map;
+    CHECK(map.Create("locked", 64) == SPOUT_CREATE_SUCCESS);
+
+    RunChild([] {
+        SpoutSharedMemory child;
+        if (child.Open("locked")) child.Lock();
+    });
+
+    uint64_t start = SpoutTest::Nanoseconds();
+    CHECK(map.Lock() != nullptr);
+    map.Unlock();
+    CHECK(SpoutTest::Nanoseconds() - start < 20000000ull);
+
+    map.Close();
+    CHECK(!Exists("locked"));
+}
+
+// Attachments of a process that exits without Close are released by the
+// others, so the segment goes away with the last live attachment
+void TestCrashAttached()
+{
+    SpoutSharedMemory map;
+    CHECK(map.Create("attached", 64) == SPOUT_CREATE_SUCCESS);
+
+    RunChild([] {
+        SpoutSharedMemory a, b;
+        a.Open("attached");
+        b.Open("attached");
+        kill(getpid(), SIGKILL);
+    });
+
+    map.Close();
+    CHECK(!Exists("attached"));
+}
+
+// A map whose creator crashed can't be opened, as with a Win32 file
+// mapping, and can be created again
+void TestCrashedCreator()
+{
+    RunChild([] {
+        SpoutSharedMemory map;
+        map.Create("orphan", 64);
+        kill(getpid(), SIGKILL);
+    });
+
+    CHECK(Exists("orphan"));
+    SpoutSharedMemory reader;
+    CHECK(!reader.Open("orphan"));
+    CHECK(!Exists("orphan"));
+
+    RunChild([] {
+        SpoutSharedMemory map;
+        map.Create("orphan", 64);
+        kill(getpid(), SIGKILL);
+    });
+
+    SpoutSharedMemory creator;
+    CHECK(creator.Create("orphan", 64) == SPOUT_CREATE_SUCCESS);
+    creator.Close();
+    CHECK(!Exists("orphan"));
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("shm");
+    TestCreateOpen();
+    TestLockPolicies();
+    TestOpenWhileLocked();
+    TestCrashWhileLocked();
+    TestCrashAttached();
+    TestCrashedCreator();
+    return SpoutTest::Finish("SharedMemoryTest");
+}
@@ -0,0 +1,105 @@
+// GetSenderSnapshot : entries, stamps, capacity and name buffer limits,
+// and the locks taken per call
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+
+namespace {
+
+const SpoutLockPolicy WaitPolicy = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+
+// Lock acquisitions of the sender set map and of all the other maps
+void CountLocks(uint64_t& set, uint64_t& others)
+{
+    SpoutLockStatsData data[64];
+    int count = SpoutLockStats::Snapshot(data, 64);
+    set = others = 0;
+    for (int i = 0; i < count && i < 64; i++)
+    {
+        if (strcmp(data[i].name, "SpoutSenderNames") == 0)
+            set += data[i].acquisitions;
+        else
+            others += data[i].acquisitions;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("snapshot");
+
+    spoutSenderNames sender, receiver;
+    receiver.SetDeferredCleanup(true);
+
+    SpoutSenderSnapshot entries[8];
+    char names[256];
+
+    CHECK(receiver.GetSenderSnapshot(entries, 8, names, sizeof(names), WaitPolicy) == 0);
+
+    // Created out of order, returned sorted by name
+    const char* created[] = { "Delta", "Alpha", "Echo", "Charlie", "Bravo" };
+    for (int i = 0; i < 5; i++)
+        CHECK(sender.CreateSender(created[i], 100 + i, 50 + i, LongToHandle(i + 1), 87 + i));
+
+    // A name without a sender is left out
+    CHECK(sender.RegisterSenderName("Orphan"));
+
+    int count = receiver.GetSenderSnapshot(entries, 8, names, sizeof(names), WaitPolicy);
+    CHECK(count == 5);
+    const char* sorted[] = { "Alpha", "Bravo", "Charlie", "Delta", "Echo" };
+    const int order[] = { 1, 4, 3, 0, 2 }; // Index in "created"
+    for (int i = 0; i < 5 && i < count; i++)
+    {
+        CHECK(entries[i].nameLength == (int)strlen(sorted[i]));
+        CHECK(strcmp(names + entries[i].nameOffset, sorted[i]) == 0);
+        CHECK(entries[i].width == 100u + order[i]);
+        CHECK(entries[i].height == 50u + order[i]);
+        CHECK(entries[i].format == 87u + order[i]);
+        CHECK(entries[i].shareHandle == (unsigned)(order[i] + 1));
+        CHECK(entries[i].stamp != 0);
+    }
+
+    // An update changes the stamp of that sender only
+    DWORD stamps[5];
+    for (int i = 0; i < 5; i++) stamps[i] = entries[i].stamp;
+    CHECK(sender.UpdateSender("Charlie", 640, 480, LongToHandle(9), 87));
+    CHECK(receiver.GetSenderSnapshot(entries, 8, names, sizeof(names), WaitPolicy) == 5);
+    for (int i = 0; i < 5; i++)
+        CHECK((entries[i].stamp != stamps[i]) == (i == 2));
+    CHECK(entries[2].width == 640 && entries[2].height == 480);
+
+    // Fewer entries than senders : the count is still returned
+    memset(entries, 0xff, sizeof(entries));
+    CHECK(receiver.GetSenderSnapshot(entries, 2, names, sizeof(names), WaitPolicy) == 5);
+    CHECK(strcmp(names + entries[1].nameOffset, "Bravo") == 0);
+    CHECK(entries[2].width == 0xffffffffu);
+
+    // Names that don't fit in the buffer have no length
+    CHECK(receiver.GetSenderSnapshot(entries, 8, names, 14, WaitPolicy) == 5);
+    CHECK(entries[0].nameLength == 5 && entries[1].nameLength == 5);
+    CHECK(entries[2].nameLength == 0);
+    CHECK(entries[2].width == 640);
+
+    // No name buffer
+    CHECK(receiver.GetSenderSnapshot(entries, 8, nullptr, 0, WaitPolicy) == 5);
+    CHECK(entries[4].nameLength == 0);
+
+    // One lock of the set and none of the info maps per call
+    SpoutLockStats::Enable(true);
+    uint64_t set0, others0, set1, others1;
+    CountLocks(set0, others0);
+    for (int i = 0; i < 10; i++)
+        receiver.GetSenderSnapshot(entries, 8, names, sizeof(names), WaitPolicy);
+    CountLocks(set1, others1);
+    SpoutLockStats::Enable(false);
+    CHECK(set1 - set0 == 10);
+    CHECK(others1 == others0);
+
+    // Released senders are gone
+    CHECK(sender.ReleaseSenderName("Alpha"));
+    CHECK(receiver.GetSenderSnapshot(entries, 8, names, sizeof(names), WaitPolicy) == 4);
+    CHECK(strcmp(names + entries[0].nameOffset, "Bravo") == 0);
+
+    return SpoutTest::Finish("SnapshotTest");
+}
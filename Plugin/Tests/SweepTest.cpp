@@ -0,0 +1,111 @@
+// SweepOrphans running against sender processes that create and release
+// senders all the time : live senders must never be swept, and the names
+// of killed senders must be removed
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+#include <signal.h>
+#include <sys/wait.h>
+#include <vector>
+
+namespace {
+
+const SpoutLockPolicy WaitPolicy = { SPOUT_LOCK_WAIT, 0, 0, 0 };
+const int Senders = 4;
+const int Cycles = 2000;
+
+// Create and release senders, returns the number of senders that were
+// missing from the set right after their creation
+int RunSender(spoutSenderNames& names, int index)
+{
+    spoutSenderNames checker;
+    HANDLE handle = LongToHandle(index + 1);
+    char name[64];
+    int lost = 0;
+
+    for (int i = 0; i < Cycles; i++)
+    {
+        snprintf(name, sizeof(name), "Sender %d-%d", index, i % 8);
+        names.CreateSender(name, 64, 64, handle);
+        if (!checker.FindSenderName(name)) lost++;
+        names.ReleaseSenderName(name);
+    }
+
+    // Left registered (names is kept alive) for the kill below
+    snprintf(name, sizeof(name), "Killed %d", index);
+    names.CreateSender(name, 64, 64, handle);
+    return lost;
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("sweep");
+
+    int done[2];
+    (void)!pipe(done);
+
+    std::vector<pid_t> senders;
+    for (int i = 0; i < Senders; i++)
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            spoutSenderNames names;
+            int lost = RunSender(names, i);
+            (void)!write(done[1], &lost, sizeof(lost));
+            for (;;) pause();
+        }
+        senders.push_back(pid);
+    }
+
+    // Sweep while the senders run
+    spoutSenderNames sweeper;
+    sweeper.SetDeferredCleanup(true);
+
+    int lost = 0, finished = 0, swept = 0;
+    while (finished < Senders)
+    {
+        swept += sweeper.SweepOrphans(WaitPolicy);
+
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(done[0], &fds);
+        timeval timeout = { 0, 0 };
+        if (select(done[0] + 1, &fds, nullptr, nullptr, &timeout) > 0)
+        {
+            int count;
+            if (read(done[0], &count, sizeof(count)) == sizeof(count))
+            {
+                lost += count;
+                finished++;
+            }
+        }
+    }
+
+    printf("SweepTest : %d live senders lost, %d names swept while running\n",
+           lost, swept);
+    CHECK(lost == 0);
+    CHECK(swept == 0);
+
+    // Killed senders : the set converges to empty
+    for (pid_t pid : senders)
+    {
+        kill(pid, SIGKILL);
+        waitpid(pid, nullptr, 0);
+    }
+
+    int sweeps = 0;
+    swept = 0;
+    while (sweeper.GetSenderCount() > 0 && sweeps < 10)
+    {
+        swept += sweeper.SweepOrphans(WaitPolicy);
+        sweeps++;
+    }
+    CHECK(swept == Senders);
+    CHECK(sweeper.GetSenderCount() == 0);
+    CHECK(sweeper.ValidateSenderSet() == 0);
+
+    return SpoutTest::Finish("SweepTest");
+}
@@ -0,0 +1,130 @@
+// CreateSender with a name left in the sender set by a sender process that
+// crashed : the name is taken over (with or without deferred cleanup),
+// while a name of a live sender process is still refused
+
+#include "Test.h"
+#include "Spout/SpoutSenderNames.h"
+#include <signal.h>
+#include <sys/wait.h>
+
+namespace {
+
+// Access to the generation and the published sender process
+class Registry : public spoutSenderNames
+{
+public:
+
+    using spoutSenderNames::getSenderSetGeneration;
+
+    DWORD senderProcess(const char* name)
+    {
+        SharedTextureInfo info;
+        if (!getSharedInfo(name, &info)) return 0;
+        DWORD pid = getSenderProcessId(&info);
+        releaseSharedInfo(name);
+        return pid;
+    }
+};
+
+// Sender process that creates a sender and waits to be killed
+pid_t StartSender(const char* name)
+{
+    int ready[2];
+    (void)!pipe(ready);
+
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        spoutSenderNames names;
+        char created = names.CreateSender(name, 64, 64, LongToHandle(1));
+        (void)!write(ready[1], &created, 1);
+        for (;;) pause();
+    }
+
+    char created = 0;
+    (void)!read(ready[0], &created, 1);
+    close(ready[0]);
+    close(ready[1]);
+    CHECK(created);
+    return pid;
+}
+
+void Kill(pid_t pid)
+{
+    kill(pid, SIGKILL);
+    waitpid(pid, nullptr, 0);
+}
+
+void Run(bool deferred)
+{
+    const char* label = deferred ? "deferred" : "immediate";
+    char crashed[64], live[64];
+    snprintf(crashed, sizeof(crashed), "Crashed %s", label);
+    snprintf(live, sizeof(live), "Live %s", label);
+
+    Registry names, checker;
+    names.SetDeferredCleanup(deferred);
+    checker.SetDeferredCleanup(true); // Leaves the orphan to "names"
+
+    // Attached before the sender process, which would otherwise take
+    // the sender set down with it
+    CHECK(names.GetSenderCount() == 0);
+    CHECK(checker.GetSenderCount() == 0);
+
+    // Sender recreated after its previous owner crashed
+    Kill(StartSender(crashed));
+    CHECK(checker.GetSenderCount() == 1);
+    CHECK(names.isSenderNameTaken(crashed) == false);
+
+    DWORD before = checker.getSenderSetGeneration();
+    bool recreated = names.CreateSender(crashed, 128, 128, LongToHandle(2));
+    DWORD after = checker.getSenderSetGeneration();
+
+    char active[SpoutMaxSenderNameLen] = {};
+    checker.GetActiveSender(active);
+    unsigned int width = 0, height = 0;
+    HANDLE handle = nullptr;
+    DWORD format = 0;
+    checker.GetSenderInfo(crashed, width, height, handle, format);
+
+    printf("TakeoverTest (%s) : recreated %d, active [%s], %ux%u, "
+           "generation %u -> %u\n", label, recreated, active, width, height,
+           (unsigned)before, (unsigned)after);
+
+    CHECK(recreated);
+    CHECK(checker.FindSenderName(crashed));
+    CHECK(strcmp(active, crashed) == 0);
+    CHECK(width == 128 && handle == LongToHandle(2));
+    CHECK(after != before);
+    CHECK(checker.senderProcess(crashed) == (DWORD)getpid());
+    // Now owned by "names" : taken for any other object of this process
+    CHECK(checker.isSenderNameTaken(crashed));
+    CHECK(!checker.CreateSender(crashed, 64, 64, LongToHandle(3)));
+    CHECK(names.UpdateSender(crashed, 256, 256, LongToHandle(2)));
+
+    // Name of a live sender process, free once the process has gone
+    pid_t pid = StartSender(live);
+    CHECK(names.isSenderNameTaken(live));
+    CHECK(!names.CreateSender(live, 64, 64, LongToHandle(4)));
+    CHECK(checker.senderProcess(live) == (DWORD)pid);
+
+    Kill(pid);
+    CHECK(names.CreateSender(live, 64, 64, LongToHandle(4)));
+    CHECK(checker.senderProcess(live) == (DWORD)getpid());
+
+    names.ReleaseSenderName(crashed);
+    names.ReleaseSenderName(live);
+    CHECK(!checker.FindSenderName(crashed));
+    CHECK(!checker.FindSenderName(live));
+    CHECK(checker.ValidateSenderSet() == 0);
+}
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("takeover");
+    Run(true);
+    Run(false);
+    return SpoutTest::Finish("TakeoverTest");
+}
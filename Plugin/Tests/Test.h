@@ -0,0 +1,133 @@
+// Minimal helpers for the Linux test and benchmark programs (see Makefile)
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <dirent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+namespace SpoutTest {
+
+inline int& Failures()
+{
+    static int count;
+    return count;
+}
+
+inline bool Check(bool ok, const char* expr, const char* file, int line)
+{
+    if (!ok)
+    {
+        fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expr);
+        Failures()++;
+    }
+    return ok;
+}
+
+#define CHECK(expr) SpoutTest::Check((expr), #expr, __FILE__, __LINE__)
+
+// Give the shared memory objects of this run a private name prefix
+// (SPOUT_SHM_NAMESPACE, see SpoutSharedMemoryPosix.cpp). Forked
+// processes inherit it.
+inline void UseNamespace(const char* test)
+{
+    char prefix[64];
+    snprintf(prefix, sizeof(prefix), "%s%d_", test, (int)getpid());
+    setenv("SPOUT_SHM_NAMESPACE", prefix, 1);
+}
+
+inline uint64_t Nanoseconds()
+{
+    using namespace std::chrono;
+    return (uint64_t)duration_cast<nanoseconds>
+      (steady_clock::now().time_since_epoch()).count();
+}
+
+// CPU time of the calling thread. Unlike the wall time, it leaves out the
+// time the thread was preempted or the machine was busy elsewhere.
+inline uint64_t ThreadNanoseconds()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+// Number of times the calling thread has blocked (waited for a mutex,
+// slept), as opposed to being preempted
+inline long Blocks()
+{
+    rusage usage;
+    getrusage(RUSAGE_THREAD, &usage);
+    return usage.ru_nvcsw;
+}
+
+// Latency samples with percentile queries
+class Samples
+{
+public:
+
+    void add(uint64_t value) { _values.push_back(value); _sorted = false; }
+
+    void merge(const Samples& other)
+    {
+        _values.insert(_values.end(), other._values.begin(), other._values.end());
+        _sorted = false;
+    }
+
+    size_t count() const { return _values.size(); }
+
+    // p in [0, 1]
+    uint64_t percentile(double p)
+    {
+        if (_values.empty()) return 0;
+        if (!_sorted) std::sort(_values.begin(), _values.end());
+        _sorted = true;
+        size_t i = (size_t)(p * (double)(_values.size() - 1) + 0.5);
+        return _values[std::min(i, _values.size() - 1)];
+    }
+
+    uint64_t max() { return percentile(1); }
+
+private:
+
+    std::vector<uint64_t> _values;
+    bool _sorted = false;
+};
+
+// Remove the shared memory objects left in the namespace of this run
+// by processes that were killed on purpose
+inline void RemoveNamespace()
+{
+    const char* prefix = getenv("SPOUT_SHM_NAMESPACE");
+    DIR* dir = prefix ? opendir("/dev/shm") : nullptr;
+    if (!dir) return;
+    while (dirent* entry = readdir(dir))
+    {
+        if (strncmp(entry->d_name, prefix, strlen(prefix)) != 0) continue;
+        std::string path = "/";
+        shm_unlink((path + entry->d_name).c_str());
+    }
+    closedir(dir);
+}
+
+// Report the result and return the process exit code
+inline int Finish(const char* test)
+{
+    RemoveNamespace();
+    if (Failures() == 0)
+        printf("%s: passed\n", test);
+    else
+        printf("%s: %d check(s) failed\n", test, Failures());
+    return Failures() == 0 ? 0 : 1;
+}
+
+} // namespace SpoutTest
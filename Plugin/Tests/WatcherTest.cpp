@@ -0,0 +1,89 @@
+// SenderListWatcher (Watcher.h) notification latency of registrations,
+// releases and legacy writes that don't bump the generation
+
+#include "Test.h"
+#include "Watcher.h"
+
+namespace {
+
+using namespace std::chrono;
+
+// Wait for the version to move from "last", returns the latency in
+// microseconds or -1 on timeout
+int64_t WaitForChange(KlakSpout::SenderListWatcher& watcher, uint32_t last)
+{
+    auto start = steady_clock::now();
+    auto limit = start + KlakSpout::SenderListWatcher::Interval * 5;
+    while (watcher.getVersion() == last)
+    {
+        if (steady_clock::now() > limit) return -1;
+        std::this_thread::sleep_for(microseconds(200));
+    }
+    return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+class Registry : public spoutSenderNames
+{
+public:
+
+    // Change the name map as a legacy application does (no generation)
+    void legacyWrite(const std::set<std::string>& names)
+    {
+        char* buf = m_senderNames.Lock();
+        writeBufferFromSenderSet(names, buf, GetMaxSenders());
+        m_senderNames.Unlock();
+    }
+};
+
+} // namespace
+
+int main()
+{
+    SpoutTest::UseNamespace("watcher");
+
+    Registry registry;
+    HANDLE handle = LongToHandle(1);
+    CHECK(registry.CreateSender("Initial", 64, 64, handle));
+
+    KlakSpout::SenderListWatcher watcher;
+
+    // First check after the maps have been opened
+    std::this_thread::sleep_for(KlakSpout::SenderListWatcher::Interval * 2);
+
+    SpoutTest::Samples latency;
+    char name[32];
+    for (int i = 0; i < 10; i++)
+    {
+        // Registration
+        snprintf(name, sizeof(name), "Sender %d", i);
+        uint32_t version = watcher.getVersion();
+        CHECK(registry.CreateSender(name, 64, 64, handle));
+        int64_t us = WaitForChange(watcher, version);
+        CHECK(us >= 0);
+        if (us >= 0) latency.add((uint64_t)us);
+
+        // Release
+        version = watcher.getVersion();
+        registry.ReleaseSenderName(name);
+        us = WaitForChange(watcher, version);
+        CHECK(us >= 0);
+        if (us >= 0) latency.add((uint64_t)us);
+    }
+
+    // Legacy change : detected by the content hash
+    uint32_t version = watcher.getVersion();
+    registry.legacyWrite({ "Initial", "Legacy" });
+    CHECK(WaitForChange(watcher, version) >= 0);
+
+    // No change : the version stays
+    std::this_thread::sleep_for(KlakSpout::SenderListWatcher::Interval * 2);
+    version = watcher.getVersion();
+    std::this_thread::sleep_for(KlakSpout::SenderListWatcher::Interval * 3);
+    CHECK(watcher.getVersion() == version);
+
+    printf("WatcherTest : notification latency p50 %.1f ms, max %.1f ms (%d changes)\n",
+           latency.percentile(0.5) * 1e-3, latency.max() * 1e-3,
+           (int)latency.count());
+
+    return SpoutTest::Finish("WatcherTest");
+}
@@ -1,11 +1,13 @@
 #pragma once
 
-#include "Common.h"
+#include "Spout/SpoutSenderNameTable.h"
+#include <objbase.h> // CoTaskMemAlloc
+#include <utility>
 
 namespace KlakSpout {
 
 //
-// Marshaling utility: std::set<std::string> -> IntPtr[]
+// Marshaling utility: SpoutSenderNameTable -> IntPtr[]
 // Returns an array of strings as IntPtr[].
 //
 // We prefer IntPtr[] over string[] because we don't know how the C# marshaler
@@ -14,23 +16,25 @@ namespace KlakSpout {
 // Although the marshaler will automatically free the array itself, the caller
 // must free each string manually.
 //
-std::pair<char**, int> MarshalStringSet(const std::set<std::string>& source)
+std::pair<char**, int> MarshalStringSet(const SpoutSenderNameTable* source)
 {
+    auto count = source ? source->Size() : 0;
+
     // Output array
     auto array = static_cast<char**>
-      (CoTaskMemAlloc(sizeof(char*) * source.size()));
+      (CoTaskMemAlloc(sizeof(char*) * count));
 
     // Copy the source strings into the output array.
-    auto i = 0u;
-    for (const auto& s : source)
+    for (auto i = 0; i < count; i++)
     {
+        auto s = (*source)[i];
         auto str = static_cast<char*>(CoTaskMemAlloc(s.size() + 1));
         s.copy(str, s.size());
         str[s.size()] = 0;
-        array[i++] = str;
+        array[i] = str;
     }
 
-    return std::make_pair(array, source.size());
+    return std::make_pair(array, count);
 }
 
 } // namespace KlakSpout
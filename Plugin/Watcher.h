@@ -0,0 +1,113 @@
+#pragma once
+
+#include "Spout/SpoutSenderNames.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace KlakSpout {
+
+// Background watcher that detects changes of the Spout sender list
+//
+// It checks the sender set generation ("SpoutSenderNamesGeneration") and a
+// hash of the name map contents a few times per second. Neither check takes
+// the map mutex or parses the names, so a UI can poll the version counter
+// every frame and only enumerate the senders when it has moved. The content
+// hash catches changes made by Spout applications that don't bump the
+// generation.
+class SenderListWatcher final
+{
+public:
+
+    SenderListWatcher() : _thread(&SenderListWatcher::run, this) {}
+
+    ~SenderListWatcher()
+    {
+        {
+            std::lock_guard<std::mutex> guard(_stopLock);
+            _stop = true;
+        }
+        _stopSignal.notify_one();
+        _thread.join();
+    }
+
+    // Change counter, incremented every time a change is detected
+    uint32_t getVersion() const
+    {
+        return _version.load(std::memory_order_relaxed);
+    }
+
+    // Check interval (the worst-case notification latency)
+    static constexpr auto Interval = std::chrono::milliseconds(100);
+
+private:
+
+    std::atomic<uint32_t> _version{0};
+
+    std::mutex _stopLock;
+    std::condition_variable _stopSignal;
+    bool _stop = false;
+
+    std::thread _thread; // Started last in the initializer list
+
+    void run()
+    {
+        SpoutSharedMemory generationMap, namesMap;
+        DWORD lastGeneration = 0;
+        uint64_t lastHash = 0;
+
+        std::unique_lock<std::mutex> lock(_stopLock);
+
+        while (!_stopSignal.wait_for(lock, Interval, [this]{ return _stop; }))
+        {
+            // The maps don't exist until the first sender registers.
+            // Open() returns immediately once a map has been opened.
+            generationMap.Open("SpoutSenderNamesGeneration");
+            namesMap.Open("SpoutSenderNames");
+
+            auto generation = readGeneration(generationMap.Buffer());
+            // The map may have been created with any number of slots.
+            auto slots = namesMap.Capacity() / SpoutMaxSenderNameLen;
+            auto hash = hashNames(namesMap.Buffer(), slots);
+
+            if (generation != lastGeneration || hash != lastHash)
+            {
+                lastGeneration = generation;
+                lastHash = hash;
+                _version.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    static DWORD readGeneration(char* buffer)
+    {
+        if (!buffer) return 0;
+        auto p = reinterpret_cast<volatile LONG*>(buffer);
+        return static_cast<DWORD>(InterlockedCompareExchange(p, 0, 0));
+    }
+
+    // FNV-1a hash of the registered names.
+    // Read without the lock: a torn read only causes an extra notification.
+    static uint64_t hashNames(const char* buffer, int slots)
+    {
+        if (!buffer) return 0;
+        uint64_t hash = 14695981039346656037ull;
+        for (auto i = 0; i < slots; i++)
+        {
+            auto slot = buffer + i * SpoutMaxSenderNameLen;
+            if (slot[0] == 0) break;
+            for (auto j = 0; j < SpoutMaxSenderNameLen && slot[j]; j++)
+                hash = (hash ^ static_cast<uint8_t>(slot[j])) * 1099511628211ull;
+            hash = (hash ^ 0xff) * 1099511628211ull; // Name separator
+        }
+        return hash;
+    }
+};
+
+// Singleton instance (created on demand)
+inline std::unique_ptr<SenderListWatcher> _watcher;
+
+} // namespace KlakSpout